@@ -0,0 +1,91 @@
+#include "lib/batch.hpp" // headless generation
+#include "lib/workpool.hpp" // parallel generation
+#include "lib/polycache.hpp" // shared suffix reuse
+#include "utils/argument.hpp" // argument fetching
+#include "utils/usage.hpp" // timing & memory reporting
+#include "utils/debug.hpp" // debugging
+
+#include <vector> // stream listing
+#include <string> // operator streams
+#include <iostream> // standard input & reporting
+#include <fstream> // stream file input
+#include <stdio.h> // report formatting
+
+// indexing
+enum BatchArgument{
+	BatchInput, // operator stream file
+	BatchOutput, // mesh output directory
+	BatchExport, // mesh export toggle
+	BatchThreads, // worker thread total
+	BatchCache, // suffix cache megabytes
+	BatchFormat, // mesh export format
+	BatchLimit // estimated face limit
+};
+
+#define BATCH_CACHE_MEGABYTES 256
+#define BATCH_USAGE "Usage: batch.exe [streamFile] [--input streamFile] [--output directory] [--export on|off] [--format obj|ply|poly|packed]\n" \
+	"\t[--threads count] [--cache megabytes] [--limit faces], counts being unsigned whole numbers\n"
+
+int main(int argc, char *argv[]){
+
+	// arguments
+	std::vector<std::string> const properties = ArgumentReader::get(argc - 1, &argv[1], {"--input", "--output", "--export", "--threads", "--cache", "--format", "--limit"}, 1);
+	std::string const directory = properties[BatchOutput] == "" ? "." : properties[BatchOutput];
+	bool const isExporting = ArgumentReader::match<bool>({{"on", true}, {"off", false}}, properties[BatchExport], true);
+	ExportFormat const format = ArgumentReader::match<ExportFormat>({{"obj", ExportObj}, {"ply", ExportPly}, {"poly", ExportPoly}, {"packed", ExportPackedPoly}}, properties[BatchFormat], ExportObj);
+	std::size_t threads, cacheMegabytes, faceLimit;
+	if(!ArgumentReader::count(properties[BatchThreads], 0, threads) || !ArgumentReader::count(properties[BatchCache], BATCH_CACHE_MEGABYTES, cacheMegabytes)
+		|| !ArgumentReader::count(properties[BatchLimit], 0, faceLimit)){
+		fprintf(stderr, "%s", BATCH_USAGE);
+		return -1;
+	}
+
+	// streams
+	std::vector<std::string> streams;
+	if(properties[BatchInput] == "" || properties[BatchInput] == "-") streams = Batch::read(std::cin);
+	else{
+		std::ifstream file(properties[BatchInput]);
+		if(!file){
+			debug("Error: operator stream file not found", properties[BatchInput]);
+			return -1;
+		}
+		streams = Batch::read(file);
+	}
+	if(streams.empty()){
+		debug("Error: no operator streams given");
+		return -1;
+	}
+
+	// generation
+	WorkPool pool(threads);
+	PolyhedronCache cache(cacheMegabytes << 20);
+	Stopwatch total;
+	std::vector<BatchResult> const results = Batch::run(streams, pool, directory, isExporting, format, cacheMegabytes > 0 ? &cache : nullptr, faceLimit);
+	double const seconds = total.getSeconds();
+
+	// report
+	int failures = 0, rejections = 0;
+	printf("%-24s %10s %10s %12s %12s\n", "operators", "vertices", "faces", "ms", "mesh_kb");
+	for(BatchResult const &result : results){
+		if(result.isRejected){
+			printf("%-24s %10zu %10zu %12s %12s\n", result.operators.c_str(), result.estimate.vertices, result.estimate.faces, "rejected", "-");
+			rejections++;
+			continue;
+		}
+		if(!result.isGenerated || (isExporting && !result.isWritten)){
+			debug("Error: stream failed", result.operators);
+			failures++;
+			continue;
+		}
+		printf("%-24s %10zu %10zu %12.3f %12zu\n", result.operators.c_str(), result.vertexTotal, result.faceTotal,
+			result.seconds * 1000.0, result.meshBytes / 1024);
+	}
+	for(std::size_t w = 0; w < pool.getThreads(); w++){
+		WorkerUsage const &usage = pool.getUsage(w);
+		printf("worker %zu: %zu jobs, %zu stolen, %.3f s busy, %.1f%% utilised\n", w, usage.jobs, usage.steals, usage.busySeconds, usage.getUtilisation() * 100.f);
+	}
+	if(cacheMegabytes > 0) printf("cache: %zu hits, %zu misses, %zu suffixes, %zu kb held\n", cache.getHits(), cache.getMisses(), cache.getEntries(), cache.getMemory() / 1024);
+	printf("total %zu streams, %i failed, %i rejected, %zu threads, %.3f s, peak %zu kb\n", streams.size(), failures, rejections, pool.getThreads(), seconds, Usage::getPeakMemory() / 1024);
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+#include "source/polyhedra.hpp" // reference generation
+#include "lib/topology.hpp" // half-edge operators
+#include "lib/canonical.hpp" // SoA canonical form
+#include "lib/arena.hpp" // intermediate storage
+#include "utils/notation.hpp" // compound operators
+#include "utils/bake.hpp" // compile-time shapes
+#include "utils/argument.hpp" // argument fetching
+#include "utils/usage.hpp" // timing & memory reporting
+#include "utils/debug.hpp" // debugging
+
+#include <vector> // corpus & results
+#include <string> // operator streams
+#include <atomic> // allocation counting
+#include <new> // allocation hooks
+#include <cstdlib> // raw allocation
+#include <algorithm> // repeat clamping
+#include <stdio.h> // JSON output
+
+// allocation counting, over every operator new in the process
+
+namespace{
+	std::atomic<std::size_t> allocationTotal(0);
+	std::atomic<std::size_t> allocationBytes(0);
+}
+
+void *operator new(std::size_t bytes){
+	allocationTotal.fetch_add(1, std::memory_order_relaxed);
+	allocationBytes.fetch_add(bytes, std::memory_order_relaxed);
+	if(void *p = std::malloc(bytes == 0 ? 1 : bytes)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+	std::free(p);
+}
+
+// indexing
+enum BenchArgument{
+	BenchOutput, // JSON output file
+	BenchRepeats // timed runs per case
+};
+
+enum BenchPath{
+	BenchMake, // PolyhedronFactory::make over the whole stream
+	BenchFactory, // PolyhedronFactory::mutate on the previous shape
+	BenchTopology // Topology or Canonical on the previous shape
+};
+
+#define BENCH_REPEATS 5
+#define BENCH_MAX_REPEATS 1000000
+#define BENCH_USAGE "Usage: bench.exe [--output jsonFile] [--repeats count], count being a whole number up to 1000000\n"
+#define BENCH_OPERATORS "dakgcsmb"
+
+struct BenchResult{
+	std::string operators;
+	char op;
+	BenchPath path;
+	std::size_t vertexTotal, faceTotal;
+	double nanoseconds; // fastest run
+	std::size_t allocations, allocatedBytes; // per run
+	std::size_t peakMemory;
+};
+
+namespace{
+	// fixed corpus of increasing depth, each operator is applied to every base
+	std::vector<std::string> const corpus = {"T", "kT", "akT", "gakT", "kgakT"};
+
+	const char *getPathName(BenchPath path){
+		switch(path){
+			case BenchMake: return "make";
+			case BenchFactory: return "factory";
+			default: return "topology";
+		}
+	}
+
+	void applyFactory(Polyhedron &p, std::string const &primitives){ // right-to-left, as a stream
+		for(std::size_t s = primitives.size(); s-- > 0;) PolyhedronFactory::mutate(p, primitives[s]);
+	}
+
+	Arena arena; // kept across runs, as a generator would between streams
+
+	void applyTopology(Polyhedron &p, std::string const &primitives){
+		for(std::size_t s = primitives.size(); s-- > 0;){
+			if(primitives[s] == 'c'){
+				Canonical canonical(p);
+				canonical.relax();
+				canonical.toPolyhedron(p);
+				continue;
+			}
+			{
+			Topology topology(p, &arena);
+			topology.mutate(primitives[s]);
+			topology.toPolyhedron(p);
+			}
+			arena.reset();
+		}
+	}
+
+	// a compile-time shape against Topology applying the same d a k g chain to the same seed
+	template <typename Seed, char... Ops>
+	bool isBakedMatch(std::string const &operators){
+		Polyhedron baked, chain;
+		FixedStream<Seed, Ops...>::toPolyhedron(baked);
+		FixedStream<Seed>::toPolyhedron(chain);
+		std::string primitives;
+		for(char op : operators) primitives += Notation::expand(op);
+		applyTopology(chain, primitives);
+		return baked.vertices == chain.vertices && baked.edges == chain.edges && baked.faces == chain.faces;
+	}
+
+	// fastest of repeated runs, with allocations counted on the last; each run mutates its own copy of the input, made untimed
+	template <typename Run>
+	BenchResult measure(std::string const &operators, char op, BenchPath path, int repeats, Polyhedron const &input, Run const &run){
+		BenchResult result{operators, op, path, 0, 0, 0.0, 0, 0, 0};
+		for(int r = 0; r < repeats; r++){
+			Polyhedron p = input;
+			std::size_t const allocations = allocationTotal.load(), bytes = allocationBytes.load();
+			Stopwatch stopwatch;
+			run(p);
+			double const nanoseconds = stopwatch.getSeconds() * 1e9;
+			result.allocations = allocationTotal.load() - allocations;
+			result.allocatedBytes = allocationBytes.load() - bytes;
+			if(r == 0 || nanoseconds < result.nanoseconds) result.nanoseconds = nanoseconds;
+			result.vertexTotal = p.vertices.size();
+			result.faceTotal = p.faces.size();
+		}
+		result.peakMemory = Usage::getPeakMemory();
+		return result;
+	}
+
+	void writeJson(FILE *fp, std::vector<BenchResult> const &results, int repeats){
+		fprintf(fp, "{\n\t\"repeats\": %i,\n\t\"peak_rss_bytes\": %zu,\n\t\"results\": [", repeats, Usage::getPeakMemory());
+		for(std::size_t r = 0; r < results.size(); r++){
+			BenchResult const &result = results[r];
+			fprintf(fp, "%s\n\t\t{\"operators\": \"%s\", \"operator\": \"%c\", \"path\": \"%s\", \"vertices\": %zu, \"faces\": %zu, "
+				"\"ns\": %.0f, \"ns_per_face\": %.3f, \"allocations\": %zu, \"allocated_bytes\": %zu, \"peak_rss_bytes\": %zu}",
+				r == 0 ? "" : ",", result.operators.c_str(), result.op, getPathName(result.path), result.vertexTotal, result.faceTotal,
+				result.nanoseconds, result.faceTotal > 0 ? result.nanoseconds / result.faceTotal : 0.0,
+				result.allocations, result.allocatedBytes, result.peakMemory);
+		}
+		fprintf(fp, "\n\t]\n}\n");
+	}
+}
+
+int main(int argc, char *argv[]){
+
+	// arguments
+	std::vector<std::string> const properties = ArgumentReader::get(argc - 1, &argv[1], {"--output", "--repeats"}, 1);
+	std::size_t repeatCount;
+	if(!ArgumentReader::count(properties[BenchRepeats], BENCH_REPEATS, repeatCount) || repeatCount > BENCH_MAX_REPEATS){
+		fprintf(stderr, "%s", BENCH_USAGE);
+		return -1;
+	}
+	int const repeats = std::max<std::size_t>(1, repeatCount);
+
+	// compile-time shapes, checked before anything is timed
+	if(!isBakedMatch<FixedSeed<'T'>, 'k', 'g', 'a', 'k'>("kgak") || !isBakedMatch<FixedSeed<'O'>, 's', 'm'>("sm") ||
+		!isBakedMatch<FixedPrism<5>, 't'>("t") || !isBakedMatch<FixedAntiprism<4>, 'b'>("b")){
+		debug("Error: compile-time shape differs from its run-time chain");
+		return -1;
+	}
+
+	// cases
+	std::vector<BenchResult> results;
+	std::string const operators = BENCH_OPERATORS;
+	for(std::string const &base : corpus){
+		std::vector<Polyhedron> const history = PolyhedronFactory::make(base);
+		if(history.empty()){
+			debug("Error: corpus stream not generated", base);
+			return -1;
+		}
+		Polyhedron const &previous = history.back();
+		for(char op : operators){
+			std::string const stream = op + base;
+			std::string const primitives = Notation::expand(op);
+			results.push_back(measure(stream, op, BenchMake, repeats, Polyhedron(), [&stream](Polyhedron &p){
+				std::vector<Polyhedron> h = PolyhedronFactory::make(stream);
+				if(!h.empty()) p = std::move(h.back());
+			}));
+			results.push_back(measure(stream, op, BenchFactory, repeats, previous, [&primitives](Polyhedron &p){
+				applyFactory(p, primitives);
+			}));
+			results.push_back(measure(stream, op, BenchTopology, repeats, previous, [op](Polyhedron &p){ // compounds in one pass
+				applyTopology(p, std::string(1, op));
+			}));
+		}
+	}
+
+	// report
+	if(properties[BenchOutput] == "" || properties[BenchOutput] == "-") writeJson(stdout, results, repeats);
+	else{
+		FILE *fp = fopen(properties[BenchOutput].c_str(), "w");
+		if(fp == NULL){
+			debug("Error: benchmark output not written", properties[BenchOutput]);
+			return -1;
+		}
+		writeJson(fp, results, repeats);
+		fclose(fp);
+	}
+	return 0;
+}
@@ -0,0 +1,57 @@
+#include "arena.hpp"
+
+#include <algorithm> // block sizing
+
+Arena::Arena(std::size_t blockBytes) : used(0), allocated(0), nextBytes(blockBytes) {}
+
+void Arena::grow(std::size_t bytes){
+	std::size_t const size = std::max(bytes, nextBytes);
+	blocks.push_back({std::unique_ptr<char[]>(new char[size]), size});
+	used = 0;
+	nextBytes *= 2;
+}
+
+void *Arena::allocate(std::size_t bytes, std::size_t alignment){
+	if(bytes == 0) bytes = 1;
+	std::size_t start = 0;
+	if(!blocks.empty()){
+		std::size_t const address = reinterpret_cast<std::size_t>(blocks.back().data.get()) + used;
+		start = used + (alignment - address % alignment) % alignment;
+	}
+	if(blocks.empty() || start + bytes > blocks.back().size){
+		grow(bytes + alignment); // new[] only guarantees fundamental alignment
+		std::size_t const address = reinterpret_cast<std::size_t>(blocks.back().data.get());
+		start = (alignment - address % alignment) % alignment;
+	}
+	used = start + bytes;
+	allocated += bytes;
+	return blocks.back().data.get() + start;
+}
+
+void Arena::reset(){
+	if(blocks.size() > 1){
+		std::vector<Block>::iterator largest = std::max_element(blocks.begin(), blocks.end(),
+			[](Block const &a, Block const &b){ return a.size < b.size; });
+		Block kept = std::move(*largest);
+		blocks.clear();
+		blocks.push_back(std::move(kept));
+	}
+	used = 0;
+	allocated = 0;
+}
+
+void Arena::release(){
+	blocks.clear();
+	used = 0;
+	allocated = 0;
+}
+
+std::size_t Arena::getAllocated() const {
+	return allocated;
+}
+
+std::size_t Arena::getReserved() const {
+	std::size_t reserved = 0;
+	for(Block const &block : blocks) reserved += block.size;
+	return reserved;
+}
@@ -0,0 +1,61 @@
+#ifndef HEADER_ARENA
+#define HEADER_ARENA
+
+#include <vector> // block listing
+#include <memory> // block ownership
+#include <new> // fallback allocation
+#include <cstddef> // byte sizes & alignment
+
+#define ARENA_BLOCK_BYTES (1 << 20)
+
+// monotonic allocator: allocations are bumped from large blocks and only given back all at once
+class Arena{
+
+	// blocks
+	struct Block{
+		std::unique_ptr<char[]> data;
+		std::size_t size;
+	};
+	std::vector<Block> blocks;
+	std::size_t used; // bytes taken from the last block
+	std::size_t allocated; // bytes handed out since the last reset
+	std::size_t nextBytes; // size of the next block, doubling as blocks are added
+	void grow(std::size_t bytes);
+
+	// usage
+public:
+	Arena(std::size_t blockBytes = ARENA_BLOCK_BYTES);
+	Arena(Arena const &) = delete;
+	Arena &operator=(Arena const &) = delete;
+	void *allocate(std::size_t bytes, std::size_t alignment);
+	void reset(); // frees everything, keeping the largest block for reuse
+	void release(); // frees everything, blocks included
+	std::size_t getAllocated() const;
+	std::size_t getReserved() const;
+};
+
+// standard allocator over an arena; without one it falls back to the global heap
+template <typename T>
+struct ArenaAllocator{
+	typedef T value_type;
+	typedef std::true_type propagate_on_container_copy_assignment;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+	Arena *arena;
+	ArenaAllocator(Arena *a = nullptr) : arena(a) {}
+	template <typename U> ArenaAllocator(ArenaAllocator<U> const &other) : arena(other.arena) {}
+	T *allocate(std::size_t n){
+		if(arena != nullptr) return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+	void deallocate(T *p, std::size_t){
+		if(arena == nullptr) ::operator delete(p);
+	}
+	template <typename U> bool operator==(ArenaAllocator<U> const &other) const { return arena == other.arena; }
+	template <typename U> bool operator!=(ArenaAllocator<U> const &other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -0,0 +1,78 @@
+#include "batch.hpp"
+#include "../utils/usage.hpp"
+#include "../utils/debug.hpp"
+
+#include <algorithm> // cost ordering
+#include <numeric> // job indices
+
+// batch methods
+
+std::vector<std::string> Batch::read(std::istream &in){
+	std::vector<std::string> streams;
+	std::string line;
+	while(std::getline(in, line)){
+		std::string::size_type comment = line.find('#');
+		if(comment != std::string::npos) line.erase(comment);
+		std::string::size_type first = line.find_first_not_of(" \t\r");
+		if(first == std::string::npos) continue;
+		std::string::size_type last = line.find_last_not_of(" \t\r");
+		streams.push_back(line.substr(first, last - first + 1));
+	}
+	return streams;
+}
+
+BatchResult Batch::generate(std::string const &operators, PolyhedronCache *cache, std::size_t faceLimit){
+	BatchResult result;
+	result.operators = operators;
+	result.isGenerated = false;
+	result.isWritten = false;
+	result.isRejected = false;
+	result.vertexTotal = result.faceTotal = 0;
+	result.seconds = 0.;
+	Stopwatch stopwatch;
+	StreamPlan const plan(operators);
+	result.estimate = plan.getCost();
+	if(plan.getValid() && faceLimit > 0 && result.estimate.faces > faceLimit){
+		result.isRejected = true;
+		result.meshBytes = 0;
+		return result;
+	}
+
+	// streams the optimiser cannot read go to the factory as given
+	if(cache != nullptr) result.isGenerated = cache->make(plan.getValid() ? plan.getStream() : operators, result.polyhedron);
+	else if(plan.getValid()) result.isGenerated = plan.make(result.polyhedron);
+	else{
+		std::vector<Polyhedron> history = PolyhedronFactory::make(operators);
+		result.isGenerated = !history.empty();
+		if(result.isGenerated) result.polyhedron = std::move(history.back());
+	}
+	result.seconds = stopwatch.getSeconds();
+	result.vertexTotal = result.polyhedron.vertices.size();
+	result.faceTotal = result.polyhedron.faces.size();
+	result.meshBytes = PolyhedronCache::getBytes(result.polyhedron);
+	return result;
+}
+
+bool Batch::write(BatchResult const &result, std::string const &directory, ExportFormat format){
+	std::string const fileName = directory + "/" + result.operators + Exporter::getExtension(format);
+	return Exporter::write(fileName, format, result.operators, result.polyhedron.vertices, result.polyhedron.edges, result.polyhedron.faces);
+}
+
+std::vector<BatchResult> Batch::run(std::vector<std::string> const &streams, WorkPool &pool, std::string const &directory, bool isExporting, ExportFormat format, PolyhedronCache *cache, std::size_t faceLimit){
+
+	// longest first, so no large stream is left to start once the others are done
+	std::vector<double> works(streams.size());
+	for(std::size_t s = 0; s < streams.size(); s++) works[s] = StreamPlan(streams[s]).getCost().work;
+	std::vector<std::size_t> order(streams.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){ return works[a] > works[b]; });
+
+	std::vector<BatchResult> results(streams.size());
+	pool.run(streams.size(), [&](std::size_t j){ // each job owns its result slot, so output order is fixed
+		BatchResult &result = results[order[j]];
+		result = generate(streams[order[j]], cache, faceLimit);
+		if(result.isGenerated && isExporting) result.isWritten = write(result, directory, format);
+		result.polyhedron = Polyhedron(); // keep only the report once written
+	});
+	return results;
+}
@@ -0,0 +1,33 @@
+#ifndef HEADER_BATCH
+#define HEADER_BATCH
+
+#include "../source/polyhedra.hpp" // polyhedron generation
+#include "workpool.hpp" // parallel generation
+#include "polycache.hpp" // shared suffix reuse
+#include "streamplan.hpp" // stream optimisation & costing
+#include "exporter.hpp" // mesh export
+
+#include <vector> // stream listing
+#include <string> // operator streams
+#include <istream> // stream reading
+
+struct BatchResult{
+	std::string operators;
+	Polyhedron polyhedron;
+	bool isGenerated;
+	bool isWritten;
+	bool isRejected; // estimated over the face limit, so never generated
+	StreamCost estimate; // zero for streams the optimiser cannot read
+	std::size_t vertexTotal, faceTotal;
+	double seconds; // generation wall time
+	std::size_t meshBytes; // storage held by this stream's polyhedron
+};
+
+struct Batch{
+	static std::vector<std::string> read(std::istream &in); // one stream per line, '#' comments
+	static BatchResult generate(std::string const &operators, PolyhedronCache *cache = nullptr, std::size_t faceLimit = 0); // 0 leaves streams unlimited
+	static bool write(BatchResult const &result, std::string const &directory, ExportFormat format);
+	static std::vector<BatchResult> run(std::vector<std::string> const &streams, WorkPool &pool, std::string const &directory, bool isExporting, ExportFormat format, PolyhedronCache *cache = nullptr, std::size_t faceLimit = 0); // costliest streams start first, results in stream order
+};
+
+#endif
@@ -1,6 +1,8 @@
 #include "camera.hpp"
 #include "../utils/debug.hpp"
 
+#include <cmath> // unbounded screen radii
+
 // transformation methods
 
 Transform::Transform(std::array<float, 3> const &p){
@@ -140,6 +142,12 @@ std::array<float, 16> const Camera::getViewProjection(){
 	return output;
 }
 
+float Camera::getScreenRadius(std::array<float, 3> const &centre, float radius, float halfHeight) const {
+	glm::vec4 const clip = projection * view * glm::vec4(centre[0], centre[1], centre[2], 1.f);
+	if(clip.w <= 0) return INFINITY; // the eye is level with or inside the sphere
+	return radius * projection[1][1] / clip.w * halfHeight; // w is 1 for orthographic & the view depth for perspective
+}
+
 // camera projection
 
 CameraProjection::CameraProjection(float fov, float n, float f) : fieldOfView(fov), near(n), far(f) {
@@ -81,6 +81,7 @@ public:
 	void insertUniforms(glm::mat4 &view, glm::mat4 &projection, glm::mat4 &rotation, glm::vec3 &position);
 	void setProjection(glm::mat4 &&p);
 	std::array<float, 16> const getViewProjection();
+	float getScreenRadius(std::array<float, 3> const &centre, float radius, float halfHeight) const; // projected sphere radius in pixels
 };
 
 struct ProjectionState{
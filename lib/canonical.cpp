@@ -0,0 +1,294 @@
+#include "canonical.hpp"
+#include "../utils/usage.hpp"
+
+#include <cmath> // vector lengths
+#include <algorithm> // chunk bounds
+
+#ifdef __SSE2__
+#include <immintrin.h> // 4-wide float kernels
+#endif
+
+namespace{
+	int const chunkSize = 4096; // loop items per pool job
+
+	void tangentPoint(float ax, float ay, float az, float bx, float by, float bz, float scale, float &dx, float &dy, float &dz){
+		float const ex = bx - ax, ey = by - ay, ez = bz - az;
+		float const t = -(ax * ex + ay * ey + az * ez) / std::max(ex * ex + ey * ey + ez * ez, 1e-20f);
+		float const px = ax + t * ex, py = ay + t * ey, pz = az + t * ez;
+		float const s = scale * (1.f - std::sqrt(px * px + py * py + pz * pz));
+		dx = s * px;
+		dy = s * py;
+		dz = s * pz;
+	}
+
+	void buildAdjacency(int vertexTotal, std::vector<int> const &owners, std::vector<int> &offsets, std::vector<int> &items, int itemShift){ // groups item indices by owning vertex
+		offsets.assign(vertexTotal + 1, 0);
+		for(int owner : owners) offsets[owner + 1]++;
+		for(int v = 0; v < vertexTotal; v++) offsets[v + 1] += offsets[v];
+		items.resize(owners.size());
+		std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+		for(int i = 0; i < (int)owners.size(); i++) items[fill[owners[i]]++] = i >> itemShift;
+	}
+}
+
+// setup
+
+Canonical::Canonical(Polyhedron const &p, WorkPool *wp) : pool(wp), cancel(nullptr), isConverged(false) {
+
+	// geometry
+	int const vertexTotal = p.vertices.size();
+	xs.resize(vertexTotal);
+	ys.resize(vertexTotal);
+	zs.resize(vertexTotal);
+	for(int v = 0; v < vertexTotal; v++){
+		xs[v] = p.vertices[v][0];
+		ys[v] = p.vertices[v][1];
+		zs[v] = p.vertices[v][2];
+	}
+
+	// edges, with both ends listed per vertex
+	std::vector<int> edgeOwners;
+	edgeOwners.reserve(p.edges.size() * 2);
+	for(std::array<int, 2> const &edge : p.edges){
+		edgeStarts.push_back(edge[0]);
+		edgeEnds.push_back(edge[1]);
+		edgeOwners.push_back(edge[0]);
+		edgeOwners.push_back(edge[1]);
+	}
+	buildAdjacency(vertexTotal, edgeOwners, vertexEdgeOffsets, vertexEdges, 1);
+
+	// face corners
+	faceOffsets.push_back(0);
+	for(std::vector<int> const &face : p.faces){
+		for(int f = 0; f < (int)face.size(); f++){
+			cornerVertices.push_back(face[f]);
+			cornerNexts.push_back(face[(f + 1) % face.size()]);
+		}
+		faceOffsets.push_back(cornerVertices.size());
+	}
+	buildAdjacency(vertexTotal, cornerVertices, vertexCornerOffsets, vertexCorners, 0);
+
+	// scratch
+	std::size_t const itemTotal = std::max(edgeStarts.size(), cornerVertices.size());
+	for(std::vector<float> *scratch : {&ax, &ay, &az, &bx, &by, &bz, &dx, &dy, &dz}) scratch->resize(itemTotal);
+	chunkSums.resize((vertexTotal / chunkSize + 1) * 3);
+}
+
+// relaxation
+
+int Canonical::relax(float tolerance, int iterationCap, float edgeRate, float faceRate){
+	isConverged = false;
+	int const vertexTotal = xs.size();
+	for(int i = 0; i < iterationCap; i++){
+		if(cancel != nullptr && cancel->load()) return i;
+		CanonicalIteration iteration;
+		oldXs = xs;
+		oldYs = ys;
+		oldZs = zs;
+		Stopwatch phase;
+		tangentify(edgeRate);
+		iteration.edgeSeconds = phase.getSeconds();
+		phase.reset();
+		recentre();
+		iteration.centreSeconds = phase.getSeconds();
+		phase.reset();
+		planarise(faceRate);
+		iteration.faceSeconds = phase.getSeconds();
+
+		// largest movement
+		parallel(vertexTotal, [&](int begin, int end){
+			float change = 0;
+			for(int v = begin; v < end; v++){
+				float const mx = xs[v] - oldXs[v], my = ys[v] - oldYs[v], mz = zs[v] - oldZs[v];
+				float const moved = mx * mx + my * my + mz * mz;
+				if(!(moved <= change)) change = moved; // keeps NaN
+			}
+			chunkSums[begin / chunkSize] = change;
+		});
+		float change = 0;
+		for(int c = 0; c * chunkSize < vertexTotal; c++) if(!(chunkSums[c] <= change)) change = chunkSums[c];
+		iteration.maxChange = std::sqrt(change);
+		iterations.push_back(iteration);
+		if(!std::isfinite(iteration.maxChange)){ // diverged; keep the last finite shape
+			xs.swap(oldXs);
+			ys.swap(oldYs);
+			zs.swap(oldZs);
+			return i + 1;
+		}
+		if(iteration.maxChange < tolerance){
+			isConverged = true;
+			return i + 1;
+		}
+	}
+	return iterationCap;
+}
+
+void Canonical::setCancel(std::atomic<bool> const *flag){
+	cancel = flag;
+}
+
+void Canonical::toPolyhedron(Polyhedron &p) const {
+	for(int v = 0; v < (int)xs.size(); v++) p.vertices[v] = {xs[v], ys[v], zs[v]};
+}
+
+bool Canonical::getConverged() const {
+	return isConverged;
+}
+
+std::vector<CanonicalIteration> const &Canonical::getIterations() const {
+	return iterations;
+}
+
+// steps
+
+void Canonical::tangentify(float rate){ // (1) pull each edge's closest point to the origin onto the unit sphere
+	int const edgeTotal = edgeStarts.size();
+	gather(edgeStarts, edgeEnds, edgeTotal);
+	float const scale = rate * .5f;
+	parallel(edgeTotal, [&](int begin, int end){
+		int e = begin;
+#ifdef __SSE2__
+		__m128 const s = _mm_set1_ps(scale), one = _mm_set1_ps(1.f), epsilon = _mm_set1_ps(1e-20f);
+		for(; e + 4 <= end; e += 4){
+			__m128 const pax = _mm_loadu_ps(&ax[e]), pay = _mm_loadu_ps(&ay[e]), paz = _mm_loadu_ps(&az[e]);
+			__m128 const ex = _mm_sub_ps(_mm_loadu_ps(&bx[e]), pax);
+			__m128 const ey = _mm_sub_ps(_mm_loadu_ps(&by[e]), pay);
+			__m128 const ez = _mm_sub_ps(_mm_loadu_ps(&bz[e]), paz);
+			__m128 const along = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pax, ex), _mm_mul_ps(pay, ey)), _mm_mul_ps(paz, ez));
+			__m128 const length = _mm_max_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)), _mm_mul_ps(ez, ez)), epsilon);
+			__m128 const t = _mm_div_ps(_mm_sub_ps(_mm_setzero_ps(), along), length);
+			__m128 const px = _mm_add_ps(pax, _mm_mul_ps(t, ex));
+			__m128 const py = _mm_add_ps(pay, _mm_mul_ps(t, ey));
+			__m128 const pz = _mm_add_ps(paz, _mm_mul_ps(t, ez));
+			__m128 const radius = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)), _mm_mul_ps(pz, pz)));
+			__m128 const factor = _mm_mul_ps(s, _mm_sub_ps(one, radius));
+			_mm_storeu_ps(&dx[e], _mm_mul_ps(factor, px));
+			_mm_storeu_ps(&dy[e], _mm_mul_ps(factor, py));
+			_mm_storeu_ps(&dz[e], _mm_mul_ps(factor, pz));
+		}
+#endif
+		for(; e < end; e++) tangentPoint(ax[e], ay[e], az[e], bx[e], by[e], bz[e], scale, dx[e], dy[e], dz[e]);
+	});
+	accumulate(vertexEdgeOffsets, vertexEdges);
+}
+
+void Canonical::recentre(){ // (2) move the centre of gravity to the origin
+	int const vertexTotal = xs.size();
+	if(vertexTotal == 0) return;
+	parallel(vertexTotal, [&](int begin, int end){
+		float sx = 0, sy = 0, sz = 0;
+		for(int v = begin; v < end; v++){
+			sx += xs[v];
+			sy += ys[v];
+			sz += zs[v];
+		}
+		float *sums = &chunkSums[begin / chunkSize * 3];
+		sums[0] = sx;
+		sums[1] = sy;
+		sums[2] = sz;
+	});
+	float centre[3] = {0, 0, 0};
+	for(int c = 0; c * chunkSize < vertexTotal; c++)
+		for(int i = 0; i < 3; i++) centre[i] += chunkSums[c * 3 + i];
+	for(int i = 0; i < 3; i++) centre[i] /= vertexTotal;
+	parallel(vertexTotal, [&](int begin, int end){
+		for(int v = begin; v < end; v++){
+			xs[v] -= centre[0];
+			ys[v] -= centre[1];
+			zs[v] -= centre[2];
+		}
+	});
+}
+
+void Canonical::planarise(float rate){ // (3) move each face's vertices towards its approximate plane
+	int const cornerTotal = cornerVertices.size();
+	int const faceTotal = faceOffsets.size() - 1;
+	gather(cornerVertices, cornerNexts, cornerTotal);
+
+	// Newell normal terms per corner
+	parallel(cornerTotal, [&](int begin, int end){
+		int c = begin;
+#ifdef __SSE2__
+		for(; c + 4 <= end; c += 4){
+			__m128 const pax = _mm_loadu_ps(&ax[c]), pay = _mm_loadu_ps(&ay[c]), paz = _mm_loadu_ps(&az[c]);
+			__m128 const pbx = _mm_loadu_ps(&bx[c]), pby = _mm_loadu_ps(&by[c]), pbz = _mm_loadu_ps(&bz[c]);
+			_mm_storeu_ps(&dx[c], _mm_mul_ps(_mm_sub_ps(pay, pby), _mm_add_ps(paz, pbz)));
+			_mm_storeu_ps(&dy[c], _mm_mul_ps(_mm_sub_ps(paz, pbz), _mm_add_ps(pax, pbx)));
+			_mm_storeu_ps(&dz[c], _mm_mul_ps(_mm_sub_ps(pax, pbx), _mm_add_ps(pay, pby)));
+		}
+#endif
+		for(; c < end; c++){
+			dx[c] = (ay[c] - by[c]) * (az[c] + bz[c]);
+			dy[c] = (az[c] - bz[c]) * (ax[c] + bx[c]);
+			dz[c] = (ax[c] - bx[c]) * (ay[c] + by[c]);
+		}
+	});
+
+	// face planes, then each corner's offset along its face normal
+	parallel(faceTotal, [&](int begin, int end){
+		for(int f = begin; f < end; f++){
+			float n[3] = {0, 0, 0}, centre[3] = {0, 0, 0};
+			for(int c = faceOffsets[f]; c < faceOffsets[f + 1]; c++){
+				n[0] += dx[c];
+				n[1] += dy[c];
+				n[2] += dz[c];
+				centre[0] += ax[c];
+				centre[1] += ay[c];
+				centre[2] += az[c];
+			}
+			float const size = faceOffsets[f + 1] - faceOffsets[f];
+			float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if(n[0] * centre[0] + n[1] * centre[1] + n[2] * centre[2] < 0) length = -length;
+			if(length == 0) length = 1;
+			for(int i = 0; i < 3; i++){
+				n[i] /= length;
+				centre[i] /= size;
+			}
+			for(int c = faceOffsets[f]; c < faceOffsets[f + 1]; c++){
+				float const k = rate * (n[0] * (centre[0] - ax[c]) + n[1] * (centre[1] - ay[c]) + n[2] * (centre[2] - az[c]));
+				dx[c] = k * n[0];
+				dy[c] = k * n[1];
+				dz[c] = k * n[2];
+			}
+		}
+	});
+	accumulate(vertexCornerOffsets, vertexCorners);
+}
+
+// loops
+
+void Canonical::parallel(int n, std::function<void(int, int)> const &body){
+	if(pool == nullptr || n <= chunkSize){
+		for(int begin = 0; begin < n; begin += chunkSize) body(begin, std::min(n, begin + chunkSize));
+		return;
+	}
+	pool->run((n + chunkSize - 1) / chunkSize, [&](std::size_t chunk){
+		int const begin = chunk * chunkSize;
+		body(begin, std::min(n, begin + chunkSize));
+	});
+}
+
+void Canonical::gather(std::vector<int> const &from, std::vector<int> const &to, int n){ // vertex positions into contiguous item arrays
+	parallel(n, [&](int begin, int end){
+		for(int i = begin; i < end; i++){
+			ax[i] = xs[from[i]], ay[i] = ys[from[i]], az[i] = zs[from[i]];
+			bx[i] = xs[to[i]], by[i] = ys[to[i]], bz[i] = zs[to[i]];
+		}
+	});
+}
+
+void Canonical::accumulate(std::vector<int> const &offsets, std::vector<int> const &sources){ // sum item corrections into their vertices
+	parallel(xs.size(), [&](int begin, int end){
+		for(int v = begin; v < end; v++){
+			float sx = 0, sy = 0, sz = 0;
+			for(int s = offsets[v]; s < offsets[v + 1]; s++){
+				sx += dx[sources[s]];
+				sy += dy[sources[s]];
+				sz += dz[sources[s]];
+			}
+			xs[v] += sx;
+			ys[v] += sy;
+			zs[v] += sz;
+		}
+	});
+}
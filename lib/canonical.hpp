@@ -0,0 +1,65 @@
+#ifndef HEADER_CANONICAL
+#define HEADER_CANONICAL
+
+#include "../source/polyhedra.hpp" // polyhedron conversion
+#include "workpool.hpp" // parallel loops
+
+#include <vector> // flat storage
+#include <functional> // loop bodies
+#include <atomic> // cancellation
+
+#define CANONICAL_TOLERANCE 1e-5f
+#define CANONICAL_ITERATIONS 1000
+#define CANONICAL_EDGE_RATE .1f
+#define CANONICAL_FACE_RATE .1f
+
+struct CanonicalIteration{
+	double edgeSeconds; // (1) edge tangency
+	double centreSeconds; // (2) recentring
+	double faceSeconds; // (3) face planarisation
+	float maxChange; // largest vertex movement
+};
+
+// iterative canonical form relaxation over structure-of-arrays vertex positions
+class Canonical{
+
+	// geometry
+	std::vector<float> xs, ys, zs;
+	std::vector<float> oldXs, oldYs, oldZs;
+
+	// topology
+	std::vector<int> edgeStarts, edgeEnds;
+	std::vector<int> faceOffsets; // face f owns corners [faceOffsets[f], faceOffsets[f + 1])
+	std::vector<int> cornerVertices, cornerNexts;
+	std::vector<int> vertexEdgeOffsets, vertexEdges; // incident edges per vertex
+	std::vector<int> vertexCornerOffsets, vertexCorners; // incident corners per vertex
+
+	// scratch
+	std::vector<float> ax, ay, az, bx, by, bz; // gathered edge ends or corner & next corner positions
+	std::vector<float> dx, dy, dz; // per edge or per corner corrections
+	std::vector<float> chunkSums; // per chunk reductions
+
+	// execution
+	WorkPool *pool;
+	std::atomic<bool> const *cancel;
+	std::vector<CanonicalIteration> iterations;
+	bool isConverged;
+	void parallel(int n, std::function<void(int, int)> const &body);
+	void gather(std::vector<int> const &from, std::vector<int> const &to, int n);
+	void accumulate(std::vector<int> const &offsets, std::vector<int> const &sources);
+	void tangentify(float rate);
+	void recentre();
+	void planarise(float rate);
+
+	// usage
+public:
+	Canonical(Polyhedron const &p, WorkPool *wp = nullptr); // without a pool, loops run on the calling thread
+	int relax(float tolerance = CANONICAL_TOLERANCE, int iterationCap = CANONICAL_ITERATIONS,
+		float edgeRate = CANONICAL_EDGE_RATE, float faceRate = CANONICAL_FACE_RATE); // returns iterations run
+	void setCancel(std::atomic<bool> const *flag); // relax stops before its next iteration once the flag is set
+	void toPolyhedron(Polyhedron &p) const; // vertex positions only
+	bool getConverged() const;
+	std::vector<CanonicalIteration> const &getIterations() const;
+};
+
+#endif
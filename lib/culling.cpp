@@ -0,0 +1,81 @@
+#include "culling.hpp"
+
+#include <cmath> // distances
+
+namespace{
+	typedef std::array<float, 4> Row;
+	float dot(Row const &a, Row const &b){
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+	}
+	float getDeterminant(Row const &a, Row const &b, Row const &c, int x, int y, int z){ // of columns x, y & z
+		return	a[x] * (b[y] * c[z] - b[z] * c[y]) -
+				a[y] * (b[x] * c[z] - b[z] * c[x]) +
+				a[z] * (b[x] * c[y] - b[y] * c[x]);
+	}
+	Row getNull(Row const &a, Row const &b, Row const &c){ // 4D cross product, perpendicular to all three rows
+		return {
+			-getDeterminant(a, b, c, 1, 2, 3),
+			getDeterminant(a, b, c, 0, 2, 3),
+			-getDeterminant(a, b, c, 0, 1, 3),
+			getDeterminant(a, b, c, 0, 1, 2)};
+	}
+}
+
+// culling
+
+int Culling::cull(std::vector<MeshCluster> const &clusters, std::array<float, 16> const &vp, std::array<float, 16> const &m, std::vector<std::array<int, 2>> &ranges){
+	ranges.clear();
+	
+	// rows of the column-major model-view-projection
+	std::array<Row, 4> rows;
+	for(int r = 0; r < 4; r++) for(int c = 0; c < 4; c++){
+		float sum = 0;
+		for(int k = 0; k < 4; k++) sum += vp[k * 4 + r] * m[c * 4 + k];
+		rows[r][c] = sum;
+	}
+	
+	// frustum planes in model space, normalised so plane distances compare with radii
+	std::array<Row, 6> planes;
+	for(int i = 0; i < 3; i++) for(int c = 0; c < 4; c++){
+		planes[i * 2][c] = rows[3][c] + rows[i][c];
+		planes[i * 2 + 1][c] = rows[3][c] - rows[i][c];
+	}
+	for(Row &plane : planes){
+		float const length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+		if(length > 0) for(float &p : plane) p /= length;
+	}
+	
+	// eye in model space, the point projecting to the centre of clip space at w = 0; a direction for orthographic views
+	Row eye = getNull(rows[0], rows[1], rows[3]);
+	bool const isPoint = std::fabs(eye[3]) > CULLING_ORTHOGRAPHIC_W * std::sqrt(dot(eye, eye));
+	if(isPoint) for(int i = 0; i < 3; i++) eye[i] /= eye[3];
+	else{
+		if(dot(rows[2], eye) > 0) for(float &e : eye) e = -e; // towards the near plane
+		float const length = std::sqrt(eye[0] * eye[0] + eye[1] * eye[1] + eye[2] * eye[2]);
+		if(length > 0) for(float &e : eye) e /= length;
+	}
+	
+	int kept = 0;
+	for(MeshCluster const &cluster : clusters){
+		Row const centre = {cluster.centre[0], cluster.centre[1], cluster.centre[2], 1};
+		bool isVisible = true;
+		for(Row const &plane : planes) if(dot(plane, centre) < -cluster.radius){
+			isVisible = false;
+			break;
+		}
+		if(!isVisible) continue;
+		
+		// normal cone facing wholly away, as seen from anywhere in the bounding sphere
+		if(isPoint){
+			std::array<float, 3> const view = {cluster.centre[0] - eye[0], cluster.centre[1] - eye[1], cluster.centre[2] - eye[2]};
+			float const distance = std::sqrt(view[0] * view[0] + view[1] * view[1] + view[2] * view[2]);
+			if(view[0] * cluster.axis[0] + view[1] * cluster.axis[1] + view[2] * cluster.axis[2] >= cluster.cutoff * distance + cluster.radius) continue;
+		}
+		else if(-(eye[0] * cluster.axis[0] + eye[1] * cluster.axis[1] + eye[2] * cluster.axis[2]) > cluster.cutoff) continue;
+		
+		kept++;
+		if(!ranges.empty() && ranges.back()[0] + ranges.back()[1] == cluster.triangleFirst) ranges.back()[1] += cluster.triangleCount;
+		else ranges.push_back({cluster.triangleFirst, cluster.triangleCount});
+	}
+	return kept;
+}
@@ -0,0 +1,17 @@
+#ifndef HEADER_CULLING
+#define HEADER_CULLING
+
+#include "model.hpp" // mesh clusters
+
+#include <vector> // visible ranges
+#include <array> // transforms
+
+#define CULLING_ORTHOGRAPHIC_W 1e-6f // eye w below which the view is taken as orthographic, its eye a direction
+
+struct Culling{
+	// clusters wholly outside the frustum of vp * m, or whose every face points away from the eye, are dropped;
+	// ranges are the remaining clusters' {triangleFirst, triangleCount}, adjacent ones merged, and the kept total is returned
+	static int cull(std::vector<MeshCluster> const &clusters, std::array<float, 16> const &vp, std::array<float, 16> const &m, std::vector<std::array<int, 2>> &ranges);
+};
+
+#endif
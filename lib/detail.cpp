@@ -0,0 +1,61 @@
+#include "detail.hpp"
+
+#include <cmath> // radii & screen areas
+
+namespace{
+	std::size_t getTriangles(Mesh const &mesh){
+		std::size_t triangles = 0;
+		for(std::vector<int> const &face : mesh.getIndexFaces()) if(face.size() > 2) triangles += face.size() - 2;
+		return triangles;
+	}
+}
+
+// setup methods
+
+DetailChain::DetailChain() : current(0), radius(0) {}
+
+void DetailChain::rebuild(std::vector<std::shared_ptr<Mesh>> const &history){
+	levels.clear();
+	current = 0;
+	radius = 0;
+	if(history.empty()) return;
+	for(std::array<float, 3> const &v : history.back()->getIndexVertices()) radius = std::max(radius, std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]));
+	
+	// newest first, then each ancestor far enough coarser than the last level taken
+	for(int m = history.size() - 1; m >= 0; m--){
+		std::size_t const triangles = getTriangles(*history[m]);
+		if(!levels.empty() && triangles * DETAIL_REDUCTION > levels.back().triangles) continue;
+		levels.push_back({m, triangles});
+	}
+}
+
+// selection methods
+
+int DetailChain::select(float screenRadius){
+	if(levels.empty()) return -1;
+	
+	// finest level whose triangles cover enough pixels each, found once with the screen area shrunk & once with it grown,
+	// so the chosen level only changes once the area is well past the threshold between levels
+	float const area = PI * screenRadius * screenRadius;
+	int finer = levels.size() - 1, coarser = levels.size() - 1;
+	for(int l = levels.size() - 1; l >= 0; l--){
+		float const needed = levels[l].triangles * DETAIL_TRIANGLE_PIXELS;
+		if(area * (1.f - DETAIL_HYSTERESIS) >= needed) finer = l;
+		if(area * (1.f + DETAIL_HYSTERESIS) >= needed) coarser = l;
+	}
+	if(finer < current) current = finer;
+	else if(coarser > current) current = coarser;
+	return levels[current].mesh;
+}
+
+int DetailChain::getLevel() const {
+	return current;
+}
+
+int DetailChain::getLevelTotal() const {
+	return levels.size();
+}
+
+float DetailChain::getRadius() const {
+	return radius;
+}
@@ -0,0 +1,40 @@
+#ifndef HEADER_DETAIL
+#define HEADER_DETAIL
+
+#include "model.hpp" // polyhedron history
+
+#include <vector> // chain levels
+#include <memory> // shared history
+#include <cstddef> // triangle totals
+
+#ifndef PI
+#define PI 3.14159
+#endif
+
+#define DETAIL_REDUCTION 3 // least ratio of triangles between a level & the next coarser one
+#define DETAIL_TRIANGLE_PIXELS 8.f // screen area in pixels each drawn triangle should cover at least
+#define DETAIL_HYSTERESIS .25f // fraction the screen area must pass a level's threshold by before switching
+
+struct DetailLevel{
+	int mesh; // position in the polyhedron history
+	std::size_t triangles;
+};
+
+// a level-of-detail chain over the operator history: every ancestor is a coarser version of the newest polyhedron,
+// as operators refine shapes around the same canonical sphere, so distant or small shapes draw an ancestor instead
+class DetailChain{
+	std::vector<DetailLevel> levels; // finest first, each at most 1 / DETAIL_REDUCTION of the triangles before it
+	int current; // chosen level
+	float radius; // bounding sphere of the newest polyhedron, about the origin
+	
+	// usage
+public:
+	DetailChain();
+	void rebuild(std::vector<std::shared_ptr<Mesh>> const &history); // after the history changes, back at the finest level
+	int select(float screenRadius); // the mesh to draw, for a bounding sphere this many pixels across its radius
+	int getLevel() const;
+	int getLevelTotal() const;
+	float getRadius() const;
+};
+
+#endif
@@ -0,0 +1,245 @@
+#include "exporter.hpp"
+#include "polyfile.hpp"
+#include "../utils/debug.hpp"
+#include "../utils/quantise.hpp"
+
+#include <cstring> // text lengths
+#include <cmath> // decimal rounding
+
+namespace{
+	void writeObj(ExportStream &out, std::string const &name, std::vector<std::array<float, 3>> const &vertices, std::vector<std::vector<int>> const &faces){
+		out.text("o ");
+		out.text(name);
+		out.text("\n");
+		for(std::array<float, 3> const &v : vertices){
+			out.text("v ");
+			out.decimal(v[0]);
+			out.text(" ");
+			out.decimal(v[1]);
+			out.text(" ");
+			out.decimal(v[2]);
+			out.text("\n");
+		}
+		for(std::vector<int> const &face : faces){
+			out.text("f");
+			for(int f : face){
+				out.text(" ");
+				out.integer(f + 1);
+			}
+			out.text("\n");
+		}
+	}
+	void writePly(ExportStream &out, std::string const &name, std::vector<std::array<float, 3>> const &vertices, std::vector<std::vector<int>> const &faces){
+		out.text("ply\nformat binary_little_endian 1.0\ncomment ");
+		out.text(name);
+		out.text("\nelement vertex ");
+		out.integer(vertices.size());
+		out.text("\nproperty float x\nproperty float y\nproperty float z\nelement face ");
+		out.integer(faces.size());
+		out.text("\nproperty list int int vertex_indices\nend_header\n");
+		for(std::array<float, 3> const &v : vertices) out.binary(v);
+		for(std::vector<int> const &face : faces){
+			out.binary((std::int32_t)face.size()); // int rather than uchar, so faces may exceed 255 corners
+			for(int f : face) out.binary((std::int32_t)f);
+		}
+	}
+	void writePoly(ExportStream &out, std::string const &name, std::vector<std::array<float, 3>> const &vertices,
+		std::vector<std::array<int, 2>> const &edges, std::vector<std::vector<int>> const &faces){
+
+		// header, checksummed over the same sequence of values written below
+		PolyFileHeader header{POLYFILE_MAGIC, POLYFILE_VERSION, (std::uint32_t)vertices.size(), (std::uint32_t)edges.size(), (std::uint32_t)faces.size(), 0, (std::uint32_t)name.size(), 0};
+		PolyChecksum checksum;
+		checksum.add(vertices.data(), vertices.size() * sizeof(std::array<float, 3>));
+		std::uint32_t offset = 0;
+		checksum.add(&offset, sizeof(offset));
+		for(std::vector<int> const &face : faces){
+			offset += face.size();
+			checksum.add(&offset, sizeof(offset));
+		}
+		header.indexTotal = offset;
+		for(std::vector<int> const &face : faces) checksum.add(face.data(), face.size() * sizeof(int));
+		checksum.add(edges.data(), edges.size() * sizeof(std::array<int, 2>));
+		checksum.add(name.data(), name.size());
+		header.checksum = checksum.hash;
+
+		// sections
+		out.binary(header);
+		for(std::array<float, 3> const &v : vertices) out.binary(v);
+		offset = 0;
+		out.binary(offset);
+		for(std::vector<int> const &face : faces){
+			offset += face.size();
+			out.binary(offset);
+		}
+		for(std::vector<int> const &face : faces)
+			for(int f : face) out.binary((std::uint32_t)f);
+		for(std::array<int, 2> const &e : edges){
+			out.binary((std::uint32_t)e[0]);
+			out.binary((std::uint32_t)e[1]);
+		}
+		for(char c : name) out.binary(c);
+	}
+	struct ChecksumSink{ // packed values hashed in sequence, as they are written
+		PolyChecksum &checksum;
+		template <typename T> void operator()(T const &value){ checksum.add(&value, sizeof(T)); }
+	};
+	struct StreamSink{
+		ExportStream &out;
+		template <typename T> void operator()(T const &value){ out.binary(value); }
+	};
+	template <typename I, typename Sink>
+	void packIndices(Sink &sink, std::vector<std::array<int, 2>> const &edges, std::vector<std::vector<int>> const &faces){
+		for(std::vector<int> const &face : faces)
+			for(int f : face) sink((I)f);
+		for(std::array<int, 2> const &e : edges){
+			sink((I)e[0]);
+			sink((I)e[1]);
+		}
+	}
+	template <typename Sink>
+	std::uint32_t packPoly(Sink &sink, float scale, std::string const &name, std::vector<std::array<float, 3>> const &vertices,
+		std::vector<std::array<int, 2>> const &edges, std::vector<std::vector<int>> const &faces){ // the sections after the header, returning the index total
+		sink(scale);
+		for(std::array<float, 3> const &v : vertices)
+			for(float x : v) sink(Quantise::toSnorm(x / scale));
+		if(vertices.size() % 2 == 1) sink((std::int16_t)0);
+		std::uint32_t offset = 0;
+		sink(offset);
+		for(std::vector<int> const &face : faces){
+			offset += face.size();
+			sink(offset);
+		}
+		if(vertices.size() <= QUANTISE_SHORT_VERTICES) packIndices<std::uint16_t>(sink, edges, faces);
+		else packIndices<std::uint32_t>(sink, edges, faces);
+		for(char c : name) sink(c);
+		return offset;
+	}
+	void writePackedPoly(ExportStream &out, std::string const &name, std::vector<std::array<float, 3>> const &vertices,
+		std::vector<std::array<int, 2>> const &edges, std::vector<std::vector<int>> const &faces){
+
+		// header, checksummed over a first pass of the values streamed below
+		float const scale = Quantise::getScale(vertices);
+		PolyChecksum checksum;
+		ChecksumSink hash{checksum};
+		std::uint32_t const indexTotal = packPoly(hash, scale, name, vertices, edges, faces);
+		PolyFileHeader const header{POLYFILE_MAGIC, POLYFILE_VERSION_PACKED, (std::uint32_t)vertices.size(), (std::uint32_t)edges.size(), (std::uint32_t)faces.size(), indexTotal, (std::uint32_t)name.size(), checksum.hash};
+
+		// sections
+		out.binary(header);
+		StreamSink write{out};
+		packPoly(write, scale, name, vertices, edges, faces);
+	}
+}
+
+// stream methods
+
+ExportStream::ExportStream(FILE *f) : fp(f), buffer(EXPORT_BUFFER_BYTES), used(0) {}
+
+ExportStream::~ExportStream(){
+	flush();
+}
+
+void ExportStream::flush(){
+	if(used > 0) fwrite(buffer.data(), 1, used, fp);
+	used = 0;
+}
+
+void ExportStream::reserve(std::size_t bytes){
+	if(used + bytes > buffer.size()) flush();
+}
+
+void ExportStream::text(const char *s){
+	bytes(s, strlen(s));
+}
+
+void ExportStream::text(std::string const &s){
+	text(s.c_str());
+}
+
+void ExportStream::bytes(char const *data, std::size_t size){
+	if(size > buffer.size()){
+		flush();
+		fwrite(data, 1, size, fp);
+		return;
+	}
+	reserve(size);
+	memcpy(&buffer[used], data, size);
+	used += size;
+}
+
+void ExportStream::integer(long long i){
+	char digits[24];
+	int d = 0;
+	unsigned long long u = i < 0 ? -(unsigned long long)i : i;
+	do{
+		digits[d++] = '0' + u % 10;
+		u /= 10;
+	} while(u > 0);
+	reserve(d + 1);
+	if(i < 0) buffer[used++] = '-';
+	while(d > 0) buffer[used++] = digits[--d];
+}
+
+void ExportStream::decimal(float f){
+	if(!(std::fabs(f) < 1e9f)){ // out of fixed-point range, or not finite
+		char formatted[32];
+		int const length = snprintf(formatted, sizeof(formatted), "%.9g", f); // at most 15 characters, exact for any float
+		reserve(length);
+		memcpy(&buffer[used], formatted, length);
+		used += length;
+		return;
+	}
+	long long const scaled = std::llround((double)f * 1000000.0);
+	unsigned long long const magnitude = scaled < 0 ? -scaled : scaled;
+	reserve(1);
+	if(scaled < 0) buffer[used++] = '-';
+	integer(magnitude / 1000000);
+	char fraction[7];
+	unsigned long long remainder = magnitude % 1000000;
+	for(int d = 5; d >= 0; d--, remainder /= 10) fraction[d] = '0' + remainder % 10;
+	fraction[6] = '\0';
+	reserve(7);
+	buffer[used++] = '.';
+	memcpy(&buffer[used], fraction, 6);
+	used += 6;
+}
+
+// exporter methods
+
+bool Exporter::write(std::string const &fileName, ExportFormat format, std::string const &name,
+	std::vector<std::array<float, 3>> const &vertices, std::vector<std::array<int, 2>> const &edges, std::vector<std::vector<int>> const &faces){
+	FILE *fp = fopen(fileName.c_str(), "wb");
+	if(fp == NULL){
+		debug("Error: export failed", fileName);
+		return false;
+	}
+	{
+	ExportStream out(fp);
+	switch(format){
+		case ExportObj:
+			writeObj(out, name, vertices, faces);
+			break;
+		case ExportPly:
+			writePly(out, name, vertices, faces);
+			break;
+		case ExportPoly:
+			writePoly(out, name, vertices, edges, faces);
+			break;
+		case ExportPackedPoly:
+			writePackedPoly(out, name, vertices, edges, faces);
+			break;
+	}
+	}
+	bool const isWritten = ferror(fp) == 0;
+	fclose(fp);
+	return isWritten;
+}
+
+const char *Exporter::getExtension(ExportFormat format){
+	switch(format){
+		case ExportPly: return ".ply";
+		case ExportPoly:
+		case ExportPackedPoly: return ".poly";
+		default: return ".obj";
+	}
+}
@@ -0,0 +1,45 @@
+#ifndef HEADER_EXPORTER
+#define HEADER_EXPORTER
+
+#include <vector> // mesh data & output buffer
+#include <array> // vertex positions
+#include <string> // file naming
+#include <stdio.h> // file output
+#include <cstdint> // binary field sizes
+
+#define EXPORT_BUFFER_BYTES (1 << 20)
+
+enum ExportFormat{
+	ExportObj, // wavefront object, n-gon faces
+	ExportPly, // binary little-endian polygon file
+	ExportPoly, // binary memory-mappable polyhedron, see polyfile.hpp
+	ExportPackedPoly // the same with 16-bit positions, and 16-bit indices where they fit
+};
+
+class ExportStream{ // large buffered writes with fixed-point text formatting
+	FILE *fp;
+	std::vector<char> buffer;
+	std::size_t used;
+	void reserve(std::size_t bytes);
+public:
+	ExportStream(FILE *f);
+	~ExportStream();
+	void flush();
+	void text(const char *s);
+	void text(std::string const &s);
+	void bytes(char const *data, std::size_t size);
+	void integer(long long i);
+	void decimal(float f); // 6 decimal places
+	template <typename T> void binary(T const &value){
+		reserve(sizeof(T));
+		for(std::size_t b = 0; b < sizeof(T); b++) buffer[used++] = reinterpret_cast<char const*>(&value)[b];
+	}
+};
+
+struct Exporter{
+	static bool write(std::string const &fileName, ExportFormat format, std::string const &name,
+		std::vector<std::array<float, 3>> const &vertices, std::vector<std::array<int, 2>> const &edges, std::vector<std::vector<int>> const &faces);
+	static const char *getExtension(ExportFormat format);
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include "gallery.hpp"
+
+#include <cmath> // radii & grid sizing
+#include <algorithm> // radius searching
+
+// gallery methods
+
+int Gallery::add(Mesh &mesh){
+	int const slot = placements.size();
+	int const base = serialVertices.size() / 3;
+	std::vector<float> const &vertices = mesh.getSerialVertices();
+	std::vector<int> const &triangles = mesh.getTriangularFaces();
+	std::vector<int> const &lines = mesh.getSerialEdges();
+	std::vector<MeshVertex> const &interleaved = mesh.getInterleavedVertices();
+
+	// shared data
+	serialVertices.insert(serialVertices.end(), vertices.begin(), vertices.end());
+	serialSlots.insert(serialSlots.end(), vertices.size() / 3, (float)slot);
+	triangleFaces.reserve(triangleFaces.size() + triangles.size());
+	for(int i : triangles) triangleFaces.push_back(base + i);
+	serialEdges.reserve(serialEdges.size() + lines.size());
+	for(int i : lines) serialEdges.push_back(base + i);
+	interleavedVertices.insert(interleavedVertices.end(), interleaved.begin(), interleaved.end());
+	interleavedSlots.insert(interleavedSlots.end(), interleaved.size(), (float)slot);
+
+	// instance
+	float radius = 0;
+	for(std::array<float, 3> const &v : mesh.getIndexVertices()) radius = std::max(radius, std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]));
+	radii.push_back(radius > 0 ? radius : 1.f);
+	placements.push_back({0, 0, 0, 1.f / radii.back()});
+	return slot;
+}
+
+void Gallery::arrange(int columns){
+	int const size = getSize();
+	if(size == 0) return;
+	if(columns < 1) columns = std::ceil(std::sqrt((float)size));
+	int const rows = (size + columns - 1) / columns;
+	float const cell = 2.f * GALLERY_EXTENT / std::max(columns, rows);
+	for(int s = 0; s < size; s++){
+		int const column = s % columns, row = s / columns;
+		std::array<float, 3> const offset = {
+			(column - (columns - 1) * .5f) * cell,
+			((rows - 1) * .5f - row) * cell,
+			0};
+		place(s, offset, cell * GALLERY_FILL / radii[s]);
+	}
+}
+
+void Gallery::place(int slot, std::array<float, 3> const &offset, float scale){
+	placements[slot] = {offset[0], offset[1], offset[2], scale};
+}
+
+int Gallery::getSize() const {
+	return placements.size();
+}
+
+std::vector<float> const &Gallery::getSerialVertices() const {
+	return serialVertices;
+}
+
+std::vector<float> const &Gallery::getSerialSlots() const {
+	return serialSlots;
+}
+
+std::vector<int> const &Gallery::getTriangularFaces() const {
+	return triangleFaces;
+}
+
+std::vector<int> const &Gallery::getSerialEdges() const {
+	return serialEdges;
+}
+
+std::vector<MeshVertex> const &Gallery::getInterleavedVertices() const {
+	return interleavedVertices;
+}
+
+std::vector<float> const &Gallery::getInterleavedSlots() const {
+	return interleavedSlots;
+}
+
+std::vector<std::array<float, 4>> const &Gallery::getPlacements() const {
+	return placements;
+}
@@ -0,0 +1,42 @@
+#ifndef HEADER_GALLERY
+#define HEADER_GALLERY
+
+#include "model.hpp" // derived mesh data
+
+#include <vector> // packed data storage
+#include <array> // placements
+
+#define GALLERY_EXTENT 1.f // half-width of the whole sheet, matching a single shape's view
+#define GALLERY_FILL .4f // shape radius as a fraction of its grid cell
+
+// many meshes packed into shared vertex & index data, each vertex tagged with its mesh's slot,
+// so a whole sheet draws in one call per renderer, placed by a per-slot table rather than per-draw uniforms
+class Gallery{
+
+	// shared data
+	std::vector<float> serialVertices;
+	std::vector<float> serialSlots; // slot per serial vertex
+	std::vector<int> triangleFaces, serialEdges; // rebased onto the shared serial vertices
+	std::vector<MeshVertex> interleavedVertices;
+	std::vector<float> interleavedSlots; // slot per interleaved vertex
+
+	// instances
+	std::vector<float> radii; // furthest vertex from each mesh's origin
+	std::vector<std::array<float, 4>> placements; // per slot offset & scale
+
+	// usage
+public:
+	int add(Mesh &mesh); // packs the mesh's derived data, returning its slot
+	void arrange(int columns = 0); // square-ish grid spanning the sheet, each shape scaled to its cell; 0 picks the columns
+	void place(int slot, std::array<float, 3> const &offset, float scale);
+	int getSize() const;
+	std::vector<float> const &getSerialVertices() const;
+	std::vector<float> const &getSerialSlots() const;
+	std::vector<int> const &getTriangularFaces() const;
+	std::vector<int> const &getSerialEdges() const;
+	std::vector<MeshVertex> const &getInterleavedVertices() const;
+	std::vector<float> const &getInterleavedSlots() const;
+	std::vector<std::array<float, 4>> const &getPlacements() const;
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "image.hpp"
+#include "../utils/debug.hpp"
+
+#include <stdio.h> // file writing
+#include <cstring> // chunk tags
+
+namespace{
+	std::uint32_t crcTable[256];
+	bool isCrcTableBuilt = false;
+	std::uint32_t getCrc(std::uint8_t const *data, std::size_t size){
+		if(!isCrcTableBuilt){
+			for(std::uint32_t n = 0; n < 256; n++){
+				std::uint32_t c = n;
+				for(int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+				crcTable[n] = c;
+			}
+			isCrcTableBuilt = true;
+		}
+		std::uint32_t c = 0xffffffffu;
+		for(std::size_t i = 0; i < size; i++) c = crcTable[(c ^ data[i]) & 0xff] ^ (c >> 8);
+		return c ^ 0xffffffffu;
+	}
+	void putBigEndian(std::vector<std::uint8_t> &out, std::uint32_t x){
+		for(int shift = 24; shift >= 0; shift -= 8) out.push_back((x >> shift) & 0xff);
+	}
+	void putChunk(std::vector<std::uint8_t> &out, char const *tag, std::vector<std::uint8_t> const &data){
+		putBigEndian(out, data.size());
+		std::size_t const start = out.size();
+		out.insert(out.end(), tag, tag + 4);
+		out.insert(out.end(), data.begin(), data.end());
+		putBigEndian(out, getCrc(&out[start], out.size() - start));
+	}
+
+	// deflate bits, least significant first
+	struct BitWriter{
+		std::vector<std::uint8_t> &out;
+		std::uint32_t buffer;
+		int count;
+		BitWriter(std::vector<std::uint8_t> &o) : out(o), buffer(0), count(0) {}
+		void put(std::uint32_t bits, int length){
+			buffer |= bits << count;
+			count += length;
+			while(count >= 8){
+				out.push_back(buffer & 0xff);
+				buffer >>= 8;
+				count -= 8;
+			}
+		}
+		void putReversed(std::uint32_t code, int length){ // Huffman codes are packed most significant first
+			std::uint32_t reversed = 0;
+			for(int i = 0; i < length; i++) reversed |= ((code >> i) & 1) << (length - 1 - i);
+			put(reversed, length);
+		}
+		void flush(){
+			if(count > 0) out.push_back(buffer & 0xff);
+			buffer = 0;
+			count = 0;
+		}
+	};
+	void putLiteral(BitWriter &bits, int symbol){ // fixed Huffman literal & length codes
+		if(symbol < 144) bits.putReversed(0x30 + symbol, 8);
+		else if(symbol < 256) bits.putReversed(0x190 + symbol - 144, 9);
+		else if(symbol < 280) bits.putReversed(symbol - 256, 7);
+		else bits.putReversed(0xc0 + symbol - 280, 8);
+	}
+	void putMatch(BitWriter &bits, int length, int distance){
+		static int const lengthBases[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+		static int const lengthExtras[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+		int l = 28;
+		while(lengthBases[l] > length) l--;
+		putLiteral(bits, 257 + l);
+		bits.put(length - lengthBases[l], lengthExtras[l]);
+		int d = distance <= 4 ? distance - 1 : 0; // only pixel distances 1 to 4 are used
+		bits.putReversed(d, 5);
+	}
+}
+
+// encoding
+
+void Image::encodePNG(int width, int height, std::uint8_t const *rgba, bool isFlipped, std::vector<std::uint8_t> &png){
+	png.clear();
+	static std::uint8_t const signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	png.insert(png.end(), signature, signature + 8);
+
+	// header
+	std::vector<std::uint8_t> header;
+	putBigEndian(header, width);
+	putBigEndian(header, height);
+	header.insert(header.end(), {8, 6, 0, 0, 0}); // 8-bit RGBA, deflate, no interlacing
+	putChunk(png, "IHDR", header);
+
+	// rows, each behind a filter byte of 0, deflated as one fixed-code block
+	std::size_t const rowBytes = (std::size_t)width * 4;
+	std::vector<std::uint8_t> zlib = {0x78, 0x01};
+	BitWriter bits(zlib);
+	bits.put(1, 1); // final block
+	bits.put(1, 2); // fixed Huffman codes
+	std::uint32_t a = 1, b = 0; // Adler-32
+	for(int y = 0; y < height; y++){
+		std::uint8_t const *row = rgba + rowBytes * (isFlipped ? height - 1 - y : y);
+		putLiteral(bits, 0);
+		b = (b + a) % 65521;
+		std::size_t x = 0;
+		while(x < rowBytes){
+			std::size_t run = 0;
+			if(x >= 4) while(run < IMAGE_MAX_MATCH && x + run < rowBytes && row[x + run] == row[x + run - 4]) run++;
+			if(run >= 3){
+				putMatch(bits, run, 4);
+				for(std::size_t i = 0; i < run; i++){
+					a = (a + row[x + i]) % 65521;
+					b = (b + a) % 65521;
+				}
+				x += run;
+				continue;
+			}
+			putLiteral(bits, row[x]);
+			a = (a + row[x]) % 65521;
+			b = (b + a) % 65521;
+			x++;
+		}
+	}
+	putLiteral(bits, 256); // end of block
+	bits.flush();
+	putBigEndian(zlib, (b << 16) | a);
+	putChunk(png, "IDAT", zlib);
+	putChunk(png, "IEND", {});
+}
+
+bool Image::writePNG(std::string const &fileName, int width, int height, std::uint8_t const *rgba, bool isFlipped){
+	std::vector<std::uint8_t> png;
+	encodePNG(width, height, rgba, isFlipped, png);
+	FILE *fp = fopen(fileName.c_str(), "wb");
+	if(fp == NULL){
+		debug("Error: image not written", fileName);
+		return false;
+	}
+	bool const isWritten = fwrite(png.data(), 1, png.size(), fp) == png.size();
+	fclose(fp);
+	if(!isWritten) debug("Error: image not written", fileName);
+	return isWritten;
+}
@@ -0,0 +1,17 @@
+#ifndef HEADER_IMAGE
+#define HEADER_IMAGE
+
+#include <string> // file names
+#include <vector> // encoded bytes
+#include <cstdint> // pixel & checksum data
+
+#define IMAGE_MAX_MATCH 258 // longest deflate match
+
+// PNG encoding without a compression library: rows are deflated with fixed Huffman codes,
+// matching only runs of the previous pixel, which shrinks flat backgrounds & faces cheaply
+struct Image{
+	static void encodePNG(int width, int height, std::uint8_t const *rgba, bool isFlipped, std::vector<std::uint8_t> &png); // isFlipped for bottom-up GL rows
+	static bool writePNG(std::string const &fileName, int width, int height, std::uint8_t const *rgba, bool isFlipped);
+};
+
+#endif
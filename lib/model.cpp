@@ -1,116 +1,357 @@
 #include "model.hpp"
+#include "triangulator.hpp"
+#include "../utils/quantise.hpp"
 #include "../utils/debug.hpp"
 
+#include <cmath> // normal lengths
+#include <algorithm> // face ordering
+#include <cstdint> // Morton codes
+
 namespace{
 	template<typename T, std::size_t N>
-	std::vector<T> getSerialData(std::vector<std::array<T, N>> data){
-		std::vector<T> out;
+	void getSerialData(std::vector<std::array<T, N>> const &data, std::vector<T> &out){
 		out.reserve(data.size() * N);
-		for(std::array<T, N> d : data) out.insert(out.end(), d.begin(), d.end());
-		return out;
+		for(std::array<T, N> const &d : data) out.insert(out.end(), d.begin(), d.end());
 	}
 	template<typename T, std::size_t U>
-	void operator+=(std::array<T, U> &a, std::array<T, U> &b){
+	void operator+=(std::array<T, U> &a, std::array<T, U> const &b){
 		for(int i = 0; i < U; i++) a[i] += b[i];
 	}
 	template<typename T, std::size_t U, typename V>
 	void operator/=(std::array<T, U> &array, V divisor){
 		for(int i = 0; i < U; i++) array[i] /= divisor;
 	}
+	template<typename T>
+	std::size_t getBytes(std::vector<T> const &data){
+		return data.capacity() * sizeof(T);
+	}
+	std::array<float, 3> getNormal(std::vector<std::array<float, 3>> const &vertices, std::vector<int> const &face){ // Newell normal, robust to slightly non-planar faces
+		std::array<float, 3> normal = {0, 0, 0};
+		for(int f = 0; f < face.size(); f++){
+			std::array<float, 3> const &a = vertices[face[f]];
+			std::array<float, 3> const &b = vertices[face[(f + 1) % face.size()]];
+			normal += std::array<float, 3>{(a[1] - b[1]) * (a[2] + b[2]), (a[2] - b[2]) * (a[0] + b[0]), (a[0] - b[0]) * (a[1] + b[1])};
+		}
+		float const length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if(length > 0) normal /= length;
+		return normal;
+	}
+	std::uint32_t getMortonCode(std::array<float, 3> const &position, std::array<float, 3> const &low, float extent){ // 10 bits per axis, interleaved
+		std::uint32_t code = 0;
+		for(int i = 0; i < 3; i++){
+			float const unit = extent > 0 ? (position[i] - low[i]) / extent : 0;
+			std::uint32_t x = std::min(1023.f, std::max(0.f, unit * 1023.f));
+			x = (x | (x << 16)) & 0x030000ff;
+			x = (x | (x << 8)) & 0x0300f00f;
+			x = (x | (x << 4)) & 0x030c30c3;
+			x = (x | (x << 2)) & 0x09249249;
+			code |= x << i;
+		}
+		return code;
+	}
 }
 
 // mesh methods
 
-Mesh::Mesh(std::vector<std::array<float, 3>> const &vs, std::vector<std::array<int, 2>> const &es, std::vector<std::vector<int>> const &fs){
-	indexVertices = vs;
-	indexEdges = es;
-	indexFaces = fs;
+Mesh::Mesh(std::vector<std::array<float, 3>> const &vs, std::vector<std::array<int, 2>> const &es, std::vector<std::vector<int>> const &fs) : 
+	indexVertices(vs), indexEdges(es), indexFaces(fs), 
+	packedScale(1), isSerialVerticesBuilt(false), isSerialEdgesBuilt(false), isTrianglesBuilt(false), isInterleavedBuilt(false), isClustersBuilt(false), isPackedBuilt(false), 
+	allocatedBytes(0) {}
+
+Mesh::Mesh(std::vector<std::array<float, 3>> &&vs, std::vector<std::array<int, 2>> &&es, std::vector<std::vector<int>> &&fs) : 
+	indexVertices(std::move(vs)), indexEdges(std::move(es)), indexFaces(std::move(fs)), 
+	packedScale(1), isSerialVerticesBuilt(false), isSerialEdgesBuilt(false), isTrianglesBuilt(false), isInterleavedBuilt(false), isClustersBuilt(false), isPackedBuilt(false), 
+	allocatedBytes(0) {}
+
+void Mesh::build(){
+	buildSerialVertices();
+	buildSerialEdges();
+	buildTriangularFaces();
+	buildInterleavedVertices();
+	buildClusters();
 }
 
-std::vector<std::array<float, 3>> Mesh::getIndexVertices(){
+std::vector<std::array<float, 3>> const &Mesh::getIndexVertices() const {
 	return indexVertices;
 }
 
-std::vector<std::array<int, 2>> Mesh::getIndexEdges(){
+std::vector<std::array<int, 2>> const &Mesh::getIndexEdges() const {
 	return indexEdges;
 }
 
-std::vector<std::vector<int>> Mesh::getIndexFaces(){
+std::vector<std::vector<int>> const &Mesh::getIndexFaces() const {
 	return indexFaces;
 }
 
-std::vector<float> Mesh::getSerialVertices(){
-	if(!serialVertices.empty()) return serialVertices;
-	serialVertices = getSerialData<float, 3>(getIndexVertices());
+std::vector<float> const &Mesh::getSerialVertices(){
+	buildSerialVertices();
 	return serialVertices;
 }
 
-std::vector<int> Mesh::getSerialEdges(){
-	if(!serialEdges.empty()) return serialEdges;
-	serialEdges = getSerialData<int, 2>(indexEdges);
+std::vector<int> const &Mesh::getSerialEdges(){
+	buildSerialEdges();
 	return serialEdges;
 }
 
-std::vector<int> Mesh::getTriangularFaces(){
-	if(!triangleFaces.empty()) return triangleFaces;
-	std::vector<std::vector<int>> faces = getIndexFaces();
-	int faceTotal = 0;
-	for(std::vector<int> face : faces) faceTotal += face.size() - 2;
-	triangleFaces.reserve(faceTotal * 3);
-	for(std::vector<int> face : faces){
-		int f2, f3;
-		for(f2 = 1, f3 = 2; f3 < face.size(); f2 = f3++){
-			triangleFaces.push_back(face[0]);
-			triangleFaces.push_back(face[f2]);
-			triangleFaces.push_back(face[f3]);
-		}
-	}
+std::vector<int> const &Mesh::getTriangularFaces(){
+	buildTriangularFaces();
 	return triangleFaces;
+}
+
+std::vector<MeshVertex> const &Mesh::getInterleavedVertices(){
+	buildInterleavedVertices();
+	return interleavedVertices;
+}
+
+std::vector<MeshCluster> const &Mesh::getClusters(){
+	buildClusters();
+	return clusters;
+}
+
+float Mesh::getPackedScale(){
+	buildPacked();
+	return packedScale;
+}
+
+std::vector<std::int16_t> const &Mesh::getPackedVertices(){
+	buildPacked();
+	return packedVertices;
+}
+
+bool Mesh::hasShortIndices() const {
+	return indexVertices.size() <= QUANTISE_SHORT_VERTICES;
+}
+
+std::vector<std::uint16_t> const &Mesh::getShortTriangularFaces(){
+	buildPacked();
+	return shortTriangles;
+}
+
+std::vector<std::uint16_t> const &Mesh::getShortSerialEdges(){
+	buildPacked();
+	return shortEdges;
+}
+
+std::vector<MeshPackedVertex> const &Mesh::getPackedInterleavedVertices(){
+	buildPacked();
+	return packedInterleaved;
+}
+
+std::size_t Mesh::getAllocatedBytes() const {
+	std::size_t bytes = allocatedBytes + getBytes(indexVertices) + getBytes(indexEdges) + getBytes(indexFaces);
+	for(std::vector<int> const &face : indexFaces) bytes += getBytes(face);
+	return bytes;
+}
+
+// mesh building
+
+void Mesh::buildSerialVertices(){
+	if(isSerialVerticesBuilt) return;
+	getSerialData<float, 3>(indexVertices, serialVertices);
+	allocatedBytes += getBytes(serialVertices);
+	isSerialVerticesBuilt = true;
+}
+
+void Mesh::buildSerialEdges(){
+	if(isSerialEdgesBuilt) return;
+	getSerialData<int, 2>(indexEdges, serialEdges);
+	allocatedBytes += getBytes(serialEdges);
+	isSerialEdgesBuilt = true;
+}
+
+void Mesh::buildTriangularFaces(){
+	if(isTrianglesBuilt) return;
+	buildClusters();
+	int triangleTotal = 0;
+	for(MeshCluster const &cluster : clusters) triangleTotal += cluster.triangleCount;
+	triangleFaces.reserve(triangleTotal * 3);
 	
+	// each cluster's faces in turn, reordered within the cluster so its triangles stay one range
+	std::vector<int> local, locals(indexVertices.size(), -1), globals;
+	std::vector<std::array<int, 3>> corners;
+	int f = 0;
+	for(MeshCluster const &cluster : clusters){
+		local.clear();
+		globals.clear();
+		for(int t = 0; t < cluster.triangleCount; f++){
+			std::vector<int> const &face = indexFaces[clusterFaces[f]];
+			if(face.size() < 3) continue;
+			corners.clear();
+			Triangulator::triangulateFace(indexVertices, face, corners);
+			for(std::array<int, 3> const &corner : corners){
+				for(int c : corner){
+					int &l = locals[face[c]];
+					if(l == -1){
+						l = globals.size();
+						globals.push_back(face[c]);
+					}
+					local.push_back(l);
+				}
+			}
+			t += corners.size();
+		}
+		Triangulator::optimise(local, globals.size());
+		for(int l : local) triangleFaces.push_back(globals[l]);
+		for(int g : globals) locals[g] = -1;
+	}
+	allocatedBytes += getBytes(triangleFaces);
+	isTrianglesBuilt = true;
 }
 
-std::vector<float> Mesh::getFanCentreVertices(){
-	if(!faceCentreVertices.empty()) return faceCentreVertices;
-	std::vector<std::array<float, 3>> vertices = getIndexVertices();
-	std::vector<std::vector<int>> faces = getIndexFaces();
-	faceCentreVertices.reserve(faces.size() * 3);
-	for(std::vector<int> face : faces){
-		std::array<float, 3> midPoint = {0,0,0};
-		for(int f : face) midPoint += vertices[f];
-		midPoint /= face.size();
-		faceCentreVertices.push_back(midPoint[0]);
-		faceCentreVertices.push_back(midPoint[1]);
-		faceCentreVertices.push_back(midPoint[2]);
+void Mesh::buildInterleavedVertices(){
+	if(isInterleavedBuilt) return;
+	buildClusters();
+	int triangleTotal = 0;
+	for(MeshCluster const &cluster : clusters) triangleTotal += cluster.triangleCount;
+	interleavedVertices.reserve(triangleTotal * 3);
+	std::vector<std::array<int, 3>> corners;
+	for(int f : clusterFaces){
+		std::vector<int> const &face = indexFaces[f];
+		if(face.size() < 3) continue;
+		std::array<float, 3> const &normal = faceNormals[f];
+		
+		// ear-clipped triangles, drawing only edges that are adjacent around the face
+		corners.clear();
+		Triangulator::triangulateFace(indexVertices, face, corners);
+		int const n = face.size();
+		for(std::array<int, 3> const &corner : corners){
+			for(int c = 0; c < 3; c++){
+				std::array<float, 3> barycentric = {0, 0, 0};
+				barycentric[c] = 1;
+				for(int e = 0; e < 3; e++){ // edge opposite corner e
+					int const gap = (corner[(e + 2) % 3] - corner[(e + 1) % 3] + n) % n;
+					if(gap != 1 && gap != n - 1) barycentric[e] = 1;
+				}
+				interleavedVertices.push_back({indexVertices[face[corner[c]]], normal, barycentric});
+			}
+		}
+	}
+	allocatedBytes += getBytes(interleavedVertices);
+	isInterleavedBuilt = true;
+}
+
+void Mesh::buildClusters(){
+	if(isClustersBuilt) return;
+	
+	// faces grouped by the axis their normal is nearest, like cube map faces, then ordered along a Morton curve through their centres,
+	// so consecutive faces lie close together & face much the same way
+	std::array<float, 3> low = {INFINITY, INFINITY, INFINITY}, high = {-INFINITY, -INFINITY, -INFINITY};
+	for(std::array<float, 3> const &v : indexVertices) for(int i = 0; i < 3; i++){
+		low[i] = std::min(low[i], v[i]);
+		high[i] = std::max(high[i], v[i]);
 	}
-	return faceCentreVertices;
-}
-
-std::vector<int> Mesh::getFanFaces(){
-	if(!fanFaces.empty()) return fanFaces;
-	std::size_t verticesTotal = getIndexVertices().size();
-	std::vector<std::vector<int>> faces = getIndexFaces();
-	int faceTotal = 0;
-	for(std::vector<int> face : faces) faceTotal += face.size();
-	fanFaces.reserve(faceTotal * 3);
-	for(int f = 0; f < faces.size(); f++){
-		int c = verticesTotal + f;
-		int f2, f3;
-		for(f2 = faces[f].size() - 1, f3 = 0; f3 < faces[f].size(); f2 = f3++){
-			fanFaces.push_back(c);
-			fanFaces.push_back(faces[f][f2]);
-			fanFaces.push_back(faces[f][f3]);
+	float const extent = indexVertices.empty() ? 0 : std::max(high[0] - low[0], std::max(high[1] - low[1], high[2] - low[2]));
+	std::vector<std::pair<std::uint64_t, int>> codes;
+	codes.reserve(indexFaces.size());
+	faceNormals.resize(indexFaces.size());
+	for(int f = 0; f < indexFaces.size(); f++){
+		std::vector<int> const &face = indexFaces[f];
+		if(face.size() < 3) continue;
+		std::array<float, 3> centre = {0, 0, 0};
+		for(int v : face) centre += indexVertices[v];
+		centre /= face.size();
+		std::array<float, 3> const &normal = faceNormals[f] = getNormal(indexVertices, face);
+		int axis = 0;
+		for(int i = 1; i < 3; i++) if(std::fabs(normal[i]) > std::fabs(normal[axis])) axis = i;
+		std::uint64_t const direction = axis * 2 + (normal[axis] < 0);
+		codes.push_back({direction << 32 | getMortonCode(centre, low, extent), f});
+	}
+	std::sort(codes.begin(), codes.end());
+	clusterFaces.reserve(codes.size());
+	for(std::pair<std::uint64_t, int> const &code : codes) clusterFaces.push_back(code.second);
+	
+	// clusters of whole faces, bounded by sphere & normal cone
+	std::vector<std::array<float, 3>> normals;
+	int triangleFirst = 0;
+	for(int first = 0; first < clusterFaces.size();){
+		MeshCluster cluster;
+		cluster.triangleFirst = triangleFirst;
+		cluster.triangleCount = 0;
+		int last = first;
+		std::array<float, 3> boxLow = {INFINITY, INFINITY, INFINITY}, boxHigh = {-INFINITY, -INFINITY, -INFINITY};
+		std::array<float, 3> axis = {0, 0, 0};
+		normals.clear();
+		while(last < clusterFaces.size() && cluster.triangleCount < MESH_CLUSTER_TRIANGLES){
+			std::vector<int> const &face = indexFaces[clusterFaces[last]];
+			std::array<float, 3> const &normal = faceNormals[clusterFaces[last]];
+			float const length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+			if(length > 0 && (normal[0] * axis[0] + normal[1] * axis[1] + normal[2] * axis[2]) < MESH_CLUSTER_SPREAD * length) break; // ends early rather than widen the cone past culling
+			for(int v : face) for(int i = 0; i < 3; i++){
+				boxLow[i] = std::min(boxLow[i], indexVertices[v][i]);
+				boxHigh[i] = std::max(boxHigh[i], indexVertices[v][i]);
+			}
+			normals.push_back(normal);
+			axis += normal;
+			cluster.triangleCount += face.size() - 2;
+			last++;
+		}
+		for(int i = 0; i < 3; i++) cluster.centre[i] = (boxLow[i] + boxHigh[i]) * .5f;
+		cluster.radius = 0;
+		for(int f = first; f < last; f++) for(int v : indexFaces[clusterFaces[f]]){
+			std::array<float, 3> const &p = indexVertices[v];
+			float const dx = p[0] - cluster.centre[0], dy = p[1] - cluster.centre[1], dz = p[2] - cluster.centre[2];
+			cluster.radius = std::max(cluster.radius, std::sqrt(dx * dx + dy * dy + dz * dz));
+		}
+		float const length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+		cluster.cutoff = 1;
+		cluster.axis = {0, 0, 1};
+		if(length > 0){
+			axis /= length;
+			float spread = 1; // cosine of the widest normal from the axis
+			for(std::array<float, 3> const &n : normals) spread = std::min(spread, n[0] * axis[0] + n[1] * axis[1] + n[2] * axis[2]);
+			cluster.axis = axis;
+			if(spread > 0) cluster.cutoff = std::sqrt(1 - spread * spread);
 		}
+		clusters.push_back(cluster);
+		triangleFirst += cluster.triangleCount;
+		first = last;
 	}
-	return fanFaces;
+	allocatedBytes += getBytes(clusterFaces) + getBytes(faceNormals) + getBytes(clusters);
+	isClustersBuilt = true;
+}
+
+void Mesh::buildPacked(){
+	if(isPackedBuilt) return;
+	buildSerialEdges();
+	buildTriangularFaces();
+	buildInterleavedVertices();
+	
+	// positions as normalised shorts of a power of two scale, padded to 8 bytes
+	packedScale = Quantise::getScale(indexVertices);
+	packedVertices.reserve(indexVertices.size() * 4);
+	for(std::array<float, 3> const &v : indexVertices){
+		for(float x : v) packedVertices.push_back(Quantise::toSnorm(x / packedScale));
+		packedVertices.push_back(0);
+	}
+	
+	// indices halved wherever every vertex is addressable
+	if(hasShortIndices()){
+		shortTriangles.assign(triangleFaces.begin(), triangleFaces.end());
+		shortEdges.assign(serialEdges.begin(), serialEdges.end());
+	}
+	
+	// interleaved corners
+	packedInterleaved.reserve(interleavedVertices.size());
+	for(MeshVertex const &vertex : interleavedVertices){
+		MeshPackedVertex packed;
+		for(int i = 0; i < 3; i++) packed.position[i] = Quantise::toSnorm(vertex.position[i] / packedScale);
+		packed.position[3] = 0;
+		packed.normal = Quantise::toOctahedral(vertex.normal);
+		for(int i = 0; i < 3; i++) packed.barycentric[i] = vertex.barycentric[i] > .5f ? 255 : 0;
+		packed.barycentric[3] = 0;
+		packedInterleaved.push_back(packed);
+	}
+	allocatedBytes += getBytes(packedVertices) + getBytes(shortTriangles) + getBytes(shortEdges) + getBytes(packedInterleaved);
+	isPackedBuilt = true;
 }
 
 // mesh overloaded functions
 
-std::ostream &operator<<(std::ostream &os, Mesh &m){
+std::ostream &operator<<(std::ostream &os, Mesh const &m){
 	os << "{\n";
-	for(std::array<float, 3> vertex : m.getIndexVertices()) os << "vertex {" << vertex[0] << " " << vertex[1] << " " << vertex[2] << "}\n";
-	for(std::array<int, 2> edge : m.getIndexEdges()) os << "edge " << edge[0] << "-" << edge[1] << "\n";
-	for(std::vector<int> face : m.getIndexFaces()){
+	for(std::array<float, 3> const &vertex : m.getIndexVertices()) os << "vertex {" << vertex[0] << " " << vertex[1] << " " << vertex[2] << "}\n";
+	for(std::array<int, 2> const &edge : m.getIndexEdges()) os << "edge " << edge[0] << "-" << edge[1] << "\n";
+	for(std::vector<int> const &face : m.getIndexFaces()){
 		if(face.empty()) continue;
 		os << "face [" << face[0];
 		for(int f = 1; f < face.size(); f++) os << " " << face[f];
@@ -118,4 +359,4 @@ std::ostream &operator<<(std::ostream &os, Mesh &m){
 	}
 	os << "}";
 	return os;
-}
\ No newline at end of file
+}
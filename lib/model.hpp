@@ -3,6 +3,32 @@
 
 #include <vector> // data storage
 #include <array> // explicit data indexing
+#include <ostream> // mesh printing
+#include <cstddef> // allocation counting
+#include <cstdint> // packed fields
+
+#define MESH_CLUSTER_TRIANGLES 64 // triangles gathered per culling cluster, in whole faces
+#define MESH_CLUSTER_SPREAD .7f // least cosine between a face normal & its cluster's mean normal
+
+struct MeshCluster{ // spatially close faces, whose triangles are contiguous in both the triangle & interleaved data
+	std::array<float, 3> centre; // bounding sphere
+	float radius;
+	std::array<float, 3> axis; // normal cone, backfacing from wherever every normal within it faces away
+	float cutoff; // sine of the cone's half-angle, 1 when the cone is too wide to ever cull
+	int triangleFirst, triangleCount;
+};
+
+struct MeshVertex{ // interleaved attributes of one triangle corner
+	std::array<float, 3> position;
+	std::array<float, 3> normal; // flat face normal
+	std::array<float, 3> barycentric; // distance weights to each opposite edge, held at 1 for diagonals which aren't drawn
+};
+
+struct MeshPackedVertex{ // 16 bytes against MeshVertex's 36, read by shaders/solidwirePackedVertex.glsl
+	std::array<std::int16_t, 4> position; // normalised against the mesh's packed scale, w padding
+	std::array<std::int16_t, 2> normal; // octahedral
+	std::array<std::uint8_t, 4> barycentric; // normalised, w padding
+};
 
 class Mesh{
 	
@@ -17,22 +43,51 @@ class Mesh{
 	
 	// processed data
 	std::vector<int> triangleFaces;
-	std::vector<float> faceCentreVertices;
-	std::vector<int> fanFaces;
+	std::vector<MeshVertex> interleavedVertices;
+	std::vector<int> clusterFaces; // face order, by Morton code of each face's centre
+	std::vector<std::array<float, 3>> faceNormals; // per face, found once for clustering & interleaving
+	std::vector<MeshCluster> clusters;
+	
+	// packed data
+	float packedScale;
+	std::vector<std::int16_t> packedVertices;
+	std::vector<std::uint16_t> shortTriangles, shortEdges;
+	std::vector<MeshPackedVertex> packedInterleaved;
+	
+	// lazy building
+	bool isSerialVerticesBuilt, isSerialEdgesBuilt, isTrianglesBuilt, isInterleavedBuilt, isClustersBuilt, isPackedBuilt;
+	std::size_t allocatedBytes; // bytes reserved by building derived data
+	void buildSerialVertices();
+	void buildSerialEdges();
+	void buildTriangularFaces();
+	void buildInterleavedVertices();
+	void buildClusters();
+	void buildPacked();
 	
 	// usage
 public:
 	Mesh(std::vector<std::array<float, 3>> const &vs, std::vector<std::array<int, 2>> const &es, std::vector<std::vector<int>> const &fs);
-	std::vector<std::array<float, 3>> getIndexVertices();
-	std::vector<std::array<int, 2>> getIndexEdges();
-	std::vector<std::vector<int>> getIndexFaces();
-	std::vector<float> getSerialVertices();
-	std::vector<int> getSerialEdges();
-	std::vector<int> getTriangularFaces();
-	std::vector<float> getFanCentreVertices();
-	std::vector<int> getFanFaces();
+	Mesh(std::vector<std::array<float, 3>> &&vs, std::vector<std::array<int, 2>> &&es, std::vector<std::vector<int>> &&fs); // takes the data of a shape that isn't kept, e.g. by thumbnail
+	void build(); // builds all derived data up front, e.g. before a timed upload
+	std::vector<std::array<float, 3>> const &getIndexVertices() const;
+	std::vector<std::array<int, 2>> const &getIndexEdges() const;
+	std::vector<std::vector<int>> const &getIndexFaces() const;
+	std::vector<float> const &getSerialVertices();
+	std::vector<int> const &getSerialEdges();
+	std::vector<int> const &getTriangularFaces(); // ear-clipped, n - 2 per face, ordered for vertex cache reuse within each cluster
+	std::vector<MeshVertex> const &getInterleavedVertices(); // unindexed ear-clipped triangles, 3 vertices each
+	std::vector<MeshCluster> const &getClusters(); // triangle ranges shared by both triangle layouts
+	
+	// packed formats, built on demand rather than by build()
+	float getPackedScale(); // packed positions times this are model positions
+	std::vector<std::int16_t> const &getPackedVertices(); // x y z padding per vertex
+	bool hasShortIndices() const; // whether the short index lists are filled
+	std::vector<std::uint16_t> const &getShortTriangularFaces();
+	std::vector<std::uint16_t> const &getShortSerialEdges();
+	std::vector<MeshPackedVertex> const &getPackedInterleavedVertices();
+	std::size_t getAllocatedBytes() const; // index data plus everything built from it
 };
 
-std::ostream &operator<<(std::ostream &os, Mesh &m);
+std::ostream &operator<<(std::ostream &os, Mesh const &m);
 
-#endif
\ No newline at end of file
+#endif
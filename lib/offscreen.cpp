@@ -0,0 +1,226 @@
+#include "offscreen.hpp"
+#include "image.hpp"
+#include "../utils/debug.hpp"
+
+#include <cstring> // extension searching
+
+namespace{
+#ifndef _WIN32
+	bool hasExtension(char const *extensions, char const *name){
+		if(extensions == NULL) return false;
+		std::size_t const length = strlen(name);
+		for(char const *at = strstr(extensions, name); at != NULL; at = strstr(at + length, name))
+			if((at == extensions || at[-1] == ' ') && (at[length] == ' ' || at[length] == '\0')) return true;
+		return false;
+	}
+#endif
+}
+
+// setup methods
+
+Offscreen::Offscreen(int w, int h) : isReady(false), width(w), height(h), framebuffer(0), colour(0), depth(0), first(0), pending(0), written(0), failed(0) {
+	packs.fill(0);
+	if(!create()) return;
+
+	// OpenGL, as Window sets it
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+	glEnable(GL_CULL_FACE);
+	glCullFace(GL_BACK);
+	glClearColor(0.f, 0.f, 0.f, 0.f); // transparent thumbnail backgrounds
+
+	// target
+	glGenRenderbuffers(1, &colour);
+	glBindRenderbuffer(GL_RENDERBUFFER, colour);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glGenRenderbuffers(1, &depth);
+	glBindRenderbuffer(GL_RENDERBUFFER, depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colour);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+	if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+		debug("Error: offscreen framebuffer incomplete");
+		return;
+	}
+	glViewport(0, 0, width, height);
+
+	// readback
+	glGenBuffers(OFFSCREEN_READBACKS, packs.data());
+	for(GLuint pack : packs){
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pack);
+		glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, NULL, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	isReady = true;
+}
+
+#ifdef _WIN32
+bool Offscreen::create(){
+	window = NULL;
+	context = NULL;
+	if(SDL_Init(SDL_INIT_VIDEO) < 0){
+		debug("SDL init failed", SDL_GetError());
+		return false;
+	}
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+	if((window = SDL_CreateWindow("Offscreen", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 1, 1, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN)) == NULL){
+		debug("SDL window creation failed", SDL_GetError());
+		return false;
+	}
+	if((context = SDL_GL_CreateContext(window)) == NULL){
+		debug("GL context creation failed", SDL_GetError());
+		return false;
+	}
+	glewExperimental = GL_TRUE;
+	GLenum const err = glewInit();
+	if(err != GLEW_OK){
+		debug("GLEW init failed", glewGetErrorString(err));
+		return false;
+	}
+	return true;
+}
+#else
+bool Offscreen::create(){
+	context = EGL_NO_CONTEXT;
+	surface = EGL_NO_SURFACE;
+
+	// display, preferring Mesa's surfaceless platform which needs no X server or GPU
+	display = EGL_NO_DISPLAY;
+	char const *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	if(hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")){
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if(getPlatformDisplay != NULL) display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if(display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	if(display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)){
+		debug("Error: EGL display not initialised", eglGetError());
+		return false;
+	}
+	if(!eglBindAPI(EGL_OPENGL_API)){
+		debug("Error: EGL OpenGL API not bound", eglGetError());
+		return false;
+	}
+
+	// context
+	EGLint const configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+		EGL_NONE};
+	EGLConfig config;
+	EGLint configTotal = 0;
+	if(!eglChooseConfig(display, configAttributes, &config, 1, &configTotal) || configTotal == 0){
+		debug("Error: no EGL config found", eglGetError());
+		return false;
+	}
+	EGLint const contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE};
+	if((context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes)) == EGL_NO_CONTEXT){
+		debug("Error: EGL context not created", eglGetError());
+		return false;
+	}
+
+	// surface, a 1x1 pbuffer unless contexts may be made current without one, as drawing goes to the framebuffer object
+	if(!hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")){
+		EGLint const surfaceAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+		if((surface = eglCreatePbufferSurface(display, config, surfaceAttributes)) == EGL_NO_SURFACE){
+			debug("Error: EGL pbuffer not created", eglGetError());
+			return false;
+		}
+	}
+	if(!eglMakeCurrent(display, surface, surface, context)){
+		debug("Error: EGL context not made current", eglGetError());
+		return false;
+	}
+
+	// GLEW, without its GLX setup which fails on a display-less machine
+	glewExperimental = GL_TRUE;
+	GLenum const err = glewContextInit();
+	if(err != GLEW_OK){
+		debug("GLEW init failed", glewGetErrorString(err));
+		return false;
+	}
+	return true;
+}
+#endif
+
+Offscreen::~Offscreen(){
+	if(isReady){
+		flush();
+		glDeleteBuffers(OFFSCREEN_READBACKS, packs.data());
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &colour);
+		glDeleteRenderbuffers(1, &depth);
+	}
+#ifdef _WIN32
+	if(context != NULL) SDL_GL_DeleteContext(context);
+	if(window != NULL) SDL_DestroyWindow(window);
+	SDL_Quit();
+#else
+	if(display != EGL_NO_DISPLAY){
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if(surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+		if(context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+		eglTerminate(display);
+	}
+#endif
+}
+
+bool Offscreen::isValid() const {
+	return isReady;
+}
+
+// frame methods
+
+void Offscreen::clear() const {
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void Offscreen::read(std::string const &fileName){
+	if(pending == OFFSCREEN_READBACKS) writeOldest();
+	int const q = (first + pending) % OFFSCREEN_READBACKS;
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, packs[q]);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0); // returns once queued, copying into the buffer later
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	names[q] = fileName;
+	pending++;
+}
+
+void Offscreen::writeOldest(){
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, packs[first]);
+	GLubyte const *pixels = (GLubyte const*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)width * height * 4, GL_MAP_READ_BIT);
+	bool isWritten = false;
+	if(pixels == NULL) debug("Error: offscreen pixels not mapped", names[first]);
+	else{
+		isWritten = Image::writePNG(names[first], width, height, pixels, true);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	first = (first + 1) % OFFSCREEN_READBACKS;
+	pending--;
+	if(isWritten) written++;
+	else failed++;
+}
+
+void Offscreen::flush(){
+	while(pending > 0) writeOldest();
+}
+
+int Offscreen::getWritten() const {
+	return written;
+}
+
+int Offscreen::getFailed() const {
+	return failed;
+}
@@ -0,0 +1,64 @@
+#ifndef HEADER_OFFSCREEN
+#define HEADER_OFFSCREEN
+
+// post-context GLEW initialisation
+#ifndef GLEW_STATIC
+#define GLEW_STATIC
+#endif
+#include "shader.hpp" // OpenGL & GLSL
+
+#ifdef _WIN32
+#include "SDL2/SDL.h" // hidden window context
+#else
+#include <EGL/egl.h> // windowless context
+#include <EGL/eglext.h> // surfaceless platform
+#endif
+
+#include <array> // readback ring
+#include <string> // image file names
+
+#define OFFSCREEN_READBACKS 3 // frames read back asynchronously before the oldest is written out
+
+// a GL 3.3 core context without a visible window, through EGL on a surfaceless or pbuffer surface (so Mesa's software
+// rasteriser serves GPU-less machines) or a hidden SDL window on Windows; frames are drawn into a framebuffer object
+// and copied into a ring of pixel pack buffers, each mapped & encoded only once the following frames are queued
+class Offscreen{
+
+	// context
+#ifdef _WIN32
+	SDL_Window *window;
+	SDL_GLContext context;
+#else
+	EGLDisplay display;
+	EGLContext context;
+	EGLSurface surface;
+#endif
+	bool isReady;
+	bool create();
+
+	// target
+	int width, height;
+	GLuint framebuffer, colour, depth;
+
+	// readback
+	std::array<GLuint, OFFSCREEN_READBACKS> packs;
+	std::array<std::string, OFFSCREEN_READBACKS> names;
+	int first, pending;
+	int written, failed;
+	void writeOldest();
+
+	// usage
+public:
+	Offscreen(int w, int h);
+	~Offscreen();
+	Offscreen(Offscreen const &) = delete;
+	Offscreen &operator=(Offscreen const &) = delete;
+	bool isValid() const;
+	void clear() const; // binds the framebuffer & clears it
+	void read(std::string const &fileName); // queues the frame's pixels, writing the oldest queued image once the ring is full
+	void flush(); // writes every queued image
+	int getWritten() const;
+	int getFailed() const;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "operatorqueue.hpp"
+#include "topology.hpp"
+#include "canonical.hpp"
+#include "../utils/usage.hpp"
+#include "../utils/debug.hpp"
+
+#include <array> // phase reporting
+
+// queue methods
+
+OperatorQueue::OperatorQueue(std::shared_ptr<Mesh const> base, WorkPool *wp) :
+	restart(std::move(base)), generation(0), isRunning(false), isStopping(false), isCancelled(false), pool(wp) {
+	worker = std::thread(&OperatorQueue::loop, this);
+}
+
+OperatorQueue::~OperatorQueue(){
+	{
+	std::lock_guard<std::mutex> guard(lock);
+	isStopping = true;
+	isCancelled = true;
+	}
+	wake.notify_all();
+	worker.join();
+}
+
+void OperatorQueue::submit(char op){
+	{
+	std::lock_guard<std::mutex> guard(lock);
+	pending.push_back(op);
+	}
+	wake.notify_all();
+}
+
+void OperatorQueue::cancel(std::shared_ptr<Mesh const> base){
+	std::lock_guard<std::mutex> guard(lock);
+	pending.clear();
+	finished.clear();
+	restart = std::move(base);
+	generation++;
+	if(isRunning) isCancelled = true;
+}
+
+bool OperatorQueue::poll(OperatorResult &result){
+	std::lock_guard<std::mutex> guard(lock);
+	if(finished.empty()) return false;
+	result = std::move(finished.front());
+	finished.pop_front();
+	return true;
+}
+
+bool OperatorQueue::isBusy(){
+	std::lock_guard<std::mutex> guard(lock);
+	return isRunning || !pending.empty() || !finished.empty();
+}
+
+void OperatorQueue::loop(){
+	std::unique_lock<std::mutex> guard(lock);
+	while(true){
+		wake.wait(guard, [this](){ return isStopping || !pending.empty(); });
+		if(isStopping) return;
+		char const op = pending.front();
+		pending.pop_front();
+		std::size_t const jobGeneration = generation;
+		Polyhedron polyhedron = std::move(tip); // restored below, or replaced by cancel
+		std::shared_ptr<Mesh const> const base = std::move(restart);
+		isRunning = true;
+		isCancelled = false;
+		guard.unlock();
+		if(base){
+			polyhedron.vertices = base->getIndexVertices();
+			polyhedron.edges = base->getIndexEdges();
+			polyhedron.faces = base->getIndexFaces();
+		}
+
+		// application, with the result's mesh built while the queue stays unlocked
+		Stopwatch stopwatch;
+		apply(op, polyhedron);
+		OperatorResult result{op, std::make_shared<Mesh>(polyhedron.vertices, polyhedron.edges, polyhedron.faces), stopwatch.getSeconds()};
+
+		guard.lock();
+		isRunning = false;
+		if(generation != jobGeneration) continue; // cancelled; tip already holds the new base
+		tip = std::move(polyhedron);
+		finished.push_back(std::move(result));
+	}
+}
+
+void OperatorQueue::apply(char op, Polyhedron &p){
+	if(op == 'c'){
+		Canonical canonical(p, pool);
+		canonical.setCancel(&isCancelled);
+		int const iterations = canonical.relax();
+		canonical.toPolyhedron(p);
+		double edgeSeconds = 0, centreSeconds = 0, faceSeconds = 0;
+		for(CanonicalIteration const &iteration : canonical.getIterations()){
+			edgeSeconds += iteration.edgeSeconds;
+			centreSeconds += iteration.centreSeconds;
+			faceSeconds += iteration.faceSeconds;
+		}
+		debug("canonical iterations", iterations);
+		debug("canonical converged", canonical.getConverged());
+		debug("canonical edge, centre & face seconds", std::array<double, 3>{edgeSeconds, centreSeconds, faceSeconds});
+		return;
+	}
+	{
+	Topology topology(p, &arena);
+	if(!topology.mutate(op)) debug("Error: operator not recognised", op);
+	else topology.toPolyhedron(p);
+	}
+	arena.reset();
+}
@@ -0,0 +1,56 @@
+#ifndef HEADER_OPERATORQUEUE
+#define HEADER_OPERATORQUEUE
+
+#include "../source/polyhedra.hpp" // operator input & output
+#include "workpool.hpp" // parallel relaxation
+#include "arena.hpp" // operator scratch storage
+#include "model.hpp" // finished meshes
+
+#include <deque> // queued operators & finished results
+#include <thread> // background application
+#include <mutex> // queue locking
+#include <condition_variable> // job signalling
+#include <atomic> // cancellation
+#include <memory> // mesh handover
+#include <cstddef> // generation counting
+
+struct OperatorResult{
+	char op;
+	std::shared_ptr<Mesh> mesh; // built on the worker, so taking it costs the caller nothing
+	double seconds;
+};
+
+// applies operators on a worker thread, each to the result of the one queued before it
+class OperatorQueue{
+
+	// jobs
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::deque<char> pending;
+	std::deque<OperatorResult> finished;
+	Polyhedron tip; // shape the next queued operator applies to
+	std::shared_ptr<Mesh const> restart; // replaces tip before the next operator, copied on the worker
+	std::size_t generation; // bumped on cancellation, so results of abandoned jobs are dropped
+	bool isRunning, isStopping;
+	std::atomic<bool> isCancelled;
+	void loop();
+
+	// application
+	WorkPool *pool;
+	Arena arena;
+	void apply(char op, Polyhedron &p);
+
+	// usage
+public:
+	OperatorQueue(std::shared_ptr<Mesh const> base, WorkPool *wp = nullptr);
+	~OperatorQueue();
+	OperatorQueue(OperatorQueue const &) = delete;
+	OperatorQueue &operator=(OperatorQueue const &) = delete;
+	void submit(char op); // d a k g c
+	void cancel(std::shared_ptr<Mesh const> base); // drops queued & finished jobs, stops the running one early where it can, and restarts from base without copying it here
+	bool poll(OperatorResult &result); // takes the oldest finished result without waiting
+	bool isBusy();
+};
+
+#endif
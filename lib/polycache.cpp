@@ -0,0 +1,124 @@
+#include "polycache.hpp"
+#include "streamplan.hpp"
+#include "arena.hpp"
+#include "../utils/notation.hpp"
+
+#include <vector> // factory output
+
+// cache methods
+
+PolyhedronCache::PolyhedronCache(std::size_t bytes) : capacity(bytes), used(0), hits(0), misses(0) {}
+
+bool PolyhedronCache::make(std::string const &operators, Polyhedron &output){
+	if(operators.empty()) return false;
+
+	// streams with operators the cache cannot step through are generated whole
+	for(std::size_t s = 0; s + 1 < operators.size(); s++){
+		if(Notation::expand(operators[s]).empty()){
+			std::vector<Polyhedron> history = PolyhedronFactory::make(operators);
+			if(history.empty()) return false;
+			output = std::move(history.back());
+			return true;
+		}
+	}
+
+	// longest cached suffix
+	std::size_t start = operators.size();
+	std::shared_ptr<Polyhedron const> base;
+	for(std::size_t s = 0; s < operators.size(); s++){
+		if((base = find(operators.substr(s)))){
+			start = s;
+			break;
+		}
+	}
+	{
+	std::lock_guard<std::mutex> guard(lock);
+	if(base) hits++;
+	else misses++;
+	}
+
+	// seed
+	if(base) output = *base;
+	else{
+		start = operators.size() - 1;
+		std::vector<Polyhedron> seed = PolyhedronFactory::make(operators.substr(start));
+		if(seed.empty()) return false;
+		output = std::move(seed.back());
+		insert(operators.substr(start), output);
+	}
+
+	// remaining operators, right-to-left, caching each suffix; intermediate half-edge arrays are reused between operators and freed with the stream
+	Arena arena;
+	for(std::size_t s = start; s-- > 0;){
+		std::size_t first = s;
+		if(operators[s] == 'c') while(first > 0 && operators[first - 1] == 'c') first--; // a run of c relaxes once
+		StreamPlan::apply(output, operators.substr(first, s - first + 1), arena);
+		s = first;
+		arena.reset();
+		insert(operators.substr(s), output);
+	}
+	return true;
+}
+
+void PolyhedronCache::clear(){
+	std::lock_guard<std::mutex> guard(lock);
+	entries.clear();
+	recency.clear();
+	used = 0;
+}
+
+std::size_t PolyhedronCache::getHits() const {
+	std::lock_guard<std::mutex> guard(lock);
+	return hits;
+}
+
+std::size_t PolyhedronCache::getMisses() const {
+	std::lock_guard<std::mutex> guard(lock);
+	return misses;
+}
+
+std::size_t PolyhedronCache::getMemory() const {
+	std::lock_guard<std::mutex> guard(lock);
+	return used;
+}
+
+std::size_t PolyhedronCache::getEntries() const {
+	std::lock_guard<std::mutex> guard(lock);
+	return entries.size();
+}
+
+std::size_t PolyhedronCache::getBytes(Polyhedron const &polyhedron){
+	std::size_t bytes = sizeof(Polyhedron);
+	bytes += polyhedron.vertices.capacity() * sizeof(std::array<float, 3>);
+	bytes += polyhedron.edges.capacity() * sizeof(std::array<int, 2>);
+	bytes += polyhedron.faces.capacity() * sizeof(std::vector<int>);
+	for(std::vector<int> const &face : polyhedron.faces) bytes += face.capacity() * sizeof(int);
+	return bytes;
+}
+
+// storage
+
+std::shared_ptr<Polyhedron const> PolyhedronCache::find(std::string const &suffix){
+	std::lock_guard<std::mutex> guard(lock);
+	std::unordered_map<std::string, Entry>::iterator it = entries.find(suffix);
+	if(it == entries.end()) return nullptr;
+	recency.splice(recency.begin(), recency, it->second.recent);
+	return it->second.polyhedron;
+}
+
+void PolyhedronCache::insert(std::string const &suffix, Polyhedron const &polyhedron){
+	std::size_t const bytes = getBytes(polyhedron) + suffix.capacity();
+	if(bytes > capacity) return;
+	std::shared_ptr<Polyhedron const> stored = std::make_shared<Polyhedron const>(polyhedron); // copied outside the lock
+	std::lock_guard<std::mutex> guard(lock);
+	if(entries.count(suffix)) return; // another worker got there first
+	while(used + bytes > capacity && !recency.empty()){ // evict least recently used
+		std::unordered_map<std::string, Entry>::iterator victim = entries.find(recency.back());
+		used -= victim->second.bytes;
+		entries.erase(victim);
+		recency.pop_back();
+	}
+	recency.push_front(suffix);
+	entries.insert({suffix, Entry{stored, bytes, recency.begin()}});
+	used += bytes;
+}
@@ -0,0 +1,45 @@
+#ifndef HEADER_POLYCACHE
+#define HEADER_POLYCACHE
+
+#include "../source/polyhedra.hpp" // polyhedron generation
+
+#include <string> // operator suffix keys
+#include <list> // recency ordering
+#include <unordered_map> // suffix lookup
+#include <memory> // shared entries
+#include <mutex> // shared access across batch workers
+#include <cstddef> // memory sizes
+
+class PolyhedronCache{
+
+	// entries
+	struct Entry{
+		std::shared_ptr<Polyhedron const> polyhedron;
+		std::size_t bytes;
+		std::list<std::string>::iterator recent;
+	};
+	std::unordered_map<std::string, Entry> entries; // keyed by operator suffix, seed included
+	std::list<std::string> recency; // most recently used first
+	mutable std::mutex lock;
+
+	// bounds
+	std::size_t capacity, used;
+	std::size_t hits, misses;
+
+	// storage
+	std::shared_ptr<Polyhedron const> find(std::string const &suffix);
+	void insert(std::string const &suffix, Polyhedron const &polyhedron);
+
+	// usage
+public:
+	PolyhedronCache(std::size_t bytes);
+	bool make(std::string const &operators, Polyhedron &output); // reuses the longest cached suffix of the stream
+	void clear();
+	std::size_t getHits() const;
+	std::size_t getMisses() const;
+	std::size_t getMemory() const;
+	std::size_t getEntries() const;
+	static std::size_t getBytes(Polyhedron const &polyhedron);
+};
+
+#endif
@@ -0,0 +1,259 @@
+#include "polyfile.hpp"
+#include "../utils/debug.hpp"
+#include "../utils/quantise.hpp"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h> // file mapping
+#else
+#include <sys/mman.h> // file mapping
+#include <sys/stat.h> // file size
+#include <fcntl.h> // file opening
+#include <unistd.h> // file closing
+#endif
+
+namespace{
+	template<typename T>
+	bool isIndexed(T const *indices, std::size_t total, std::uint32_t vertexTotal){ // every index names a vertex
+		for(std::size_t i = 0; i < total; i++) if(indices[i] >= vertexTotal) return false;
+		return true;
+	}
+}
+
+// checksum
+
+PolyChecksum::PolyChecksum() : hash(2166136261u) {}
+
+void PolyChecksum::add(void const *data, std::size_t bytes){
+	unsigned char const *b = static_cast<unsigned char const*>(data);
+	for(std::size_t i = 0; i < bytes; i++) hash = (hash ^ b[i]) * 16777619u;
+}
+
+// mapping
+
+PolyFile::PolyFile() : mapping(nullptr), size(0),
+#ifdef _WIN32
+	file(INVALID_HANDLE_VALUE), view(NULL),
+#else
+	file(-1),
+#endif
+	header(nullptr), vertices(nullptr), faceOffsets(nullptr), faceIndices(nullptr), edges(nullptr), 
+	scale(1), packedVertices(nullptr), shortFaceIndices(nullptr), shortEdges(nullptr), operators(nullptr) {}
+
+PolyFile::~PolyFile(){
+	close();
+}
+
+bool PolyFile::open(std::string const &fileName, bool isVerified){
+	close();
+
+	// map
+#ifdef _WIN32
+	file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE){
+		debug("Error: polyhedron file not found", fileName);
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize)){
+		debug("Error: polyhedron file size unknown", fileName);
+		close();
+		return false;
+	}
+	size = fileSize.QuadPart;
+	if(size < sizeof(PolyFileHeader) || (view = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL)) == NULL ||
+		(mapping = MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0)) == NULL){
+		debug("Error: polyhedron file not mapped", fileName);
+		close();
+		return false;
+	}
+#else
+	if((file = ::open(fileName.c_str(), O_RDONLY)) == -1){
+		debug("Error: polyhedron file not found", fileName);
+		return false;
+	}
+	struct stat status;
+	if(fstat(file, &status) == -1){
+		debug("Error: polyhedron file size unknown", fileName);
+		close();
+		return false;
+	}
+	size = status.st_size;
+	if(size < sizeof(PolyFileHeader) || (mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0)) == MAP_FAILED){
+		mapping = nullptr;
+		debug("Error: polyhedron file not mapped", fileName);
+		close();
+		return false;
+	}
+#endif
+
+	// header
+	header = static_cast<PolyFileHeader const*>(mapping);
+	if(header->magic != POLYFILE_MAGIC || (header->version != POLYFILE_VERSION && header->version != POLYFILE_VERSION_PACKED)){
+		debug("Error: polyhedron file format not recognised", fileName);
+		close();
+		return false;
+	}
+	bool const isShort = isPacked() && header->vertexTotal <= QUANTISE_SHORT_VERTICES;
+	std::size_t const vertexBytes = isPacked() ? 
+		sizeof(float) + sizeof(std::int16_t) * (3 * (std::size_t)header->vertexTotal + header->vertexTotal % 2) : 
+		sizeof(float) * 3 * (std::size_t)header->vertexTotal;
+	std::size_t const expected = sizeof(PolyFileHeader) + vertexBytes + sizeof(std::uint32_t) * ((std::size_t)header->faceTotal + 1) +
+		(isShort ? sizeof(std::uint16_t) : sizeof(std::uint32_t)) * (header->indexTotal + 2 * (std::size_t)header->edgeTotal) + header->operatorLength;
+	if(size != expected){
+		debug("Error: polyhedron file truncated", fileName);
+		close();
+		return false;
+	}
+
+	// sections
+	char const *data = static_cast<char const*>(mapping) + sizeof(PolyFileHeader);
+	if(isPacked()){
+		scale = *reinterpret_cast<float const*>(data);
+		packedVertices = reinterpret_cast<std::int16_t const*>(data + sizeof(float));
+	}
+	else vertices = reinterpret_cast<float const*>(data);
+	faceOffsets = reinterpret_cast<std::uint32_t const*>(data + vertexBytes);
+	if(isShort){
+		shortFaceIndices = reinterpret_cast<std::uint16_t const*>(faceOffsets + header->faceTotal + 1);
+		shortEdges = shortFaceIndices + header->indexTotal;
+		operators = reinterpret_cast<char const*>(shortEdges + 2 * header->edgeTotal);
+	}
+	else{
+		faceIndices = faceOffsets + header->faceTotal + 1;
+		edges = faceIndices + header->indexTotal;
+		operators = reinterpret_cast<char const*>(edges + 2 * header->edgeTotal);
+	}
+	if(isVerified){
+		PolyChecksum checksum;
+		checksum.add(data, size - sizeof(PolyFileHeader));
+		if(checksum.hash != header->checksum){
+			debug("Error: polyhedron file checksum mismatch", fileName);
+			close();
+			return false;
+		}
+	}
+
+	// bounds, checked even unverified so the pointers can be read without any
+	bool isBounded = faceOffsets[0] == 0 && faceOffsets[header->faceTotal] == header->indexTotal;
+	for(std::uint32_t f = 0; isBounded && f < header->faceTotal; f++) isBounded = faceOffsets[f] <= faceOffsets[f + 1];
+	if(isBounded) isBounded = isShort ? 
+		isIndexed(shortFaceIndices, header->indexTotal + 2 * (std::size_t)header->edgeTotal, header->vertexTotal) : 
+		isIndexed(faceIndices, header->indexTotal + 2 * (std::size_t)header->edgeTotal, header->vertexTotal);
+	if(!isBounded){
+		debug("Error: polyhedron file faces malformed", fileName);
+		close();
+		return false;
+	}
+	return true;
+}
+
+void PolyFile::close(){
+#ifdef _WIN32
+	if(mapping != nullptr) UnmapViewOfFile(mapping);
+	if(view != NULL) CloseHandle(view);
+	if(file != INVALID_HANDLE_VALUE) CloseHandle(file);
+	view = NULL;
+	file = INVALID_HANDLE_VALUE;
+#else
+	if(mapping != nullptr) munmap(mapping, size);
+	if(file != -1) ::close(file);
+	file = -1;
+#endif
+	mapping = nullptr;
+	size = 0;
+	header = nullptr;
+	vertices = nullptr;
+	faceOffsets = faceIndices = edges = nullptr;
+	scale = 1;
+	packedVertices = nullptr;
+	shortFaceIndices = shortEdges = nullptr;
+	operators = nullptr;
+}
+
+bool PolyFile::isOpen() const {
+	return header != nullptr;
+}
+
+// access
+
+std::uint32_t PolyFile::getVertexTotal() const {
+	return header->vertexTotal;
+}
+
+std::uint32_t PolyFile::getEdgeTotal() const {
+	return header->edgeTotal;
+}
+
+std::uint32_t PolyFile::getFaceTotal() const {
+	return header->faceTotal;
+}
+
+std::uint32_t PolyFile::getIndexTotal() const {
+	return header->indexTotal;
+}
+
+float const *PolyFile::getVertices() const {
+	return vertices;
+}
+
+std::uint32_t const *PolyFile::getFaceOffsets() const {
+	return faceOffsets;
+}
+
+std::uint32_t const *PolyFile::getFaceIndices() const {
+	return faceIndices;
+}
+
+std::uint32_t const *PolyFile::getEdges() const {
+	return edges;
+}
+
+std::string PolyFile::getOperators() const {
+	return std::string(operators, header->operatorLength);
+}
+
+bool PolyFile::isPacked() const {
+	return header->version == POLYFILE_VERSION_PACKED;
+}
+
+float PolyFile::getScale() const {
+	return scale;
+}
+
+std::int16_t const *PolyFile::getPackedVertices() const {
+	return packedVertices;
+}
+
+std::uint16_t const *PolyFile::getShortFaceIndices() const {
+	return shortFaceIndices;
+}
+
+std::uint16_t const *PolyFile::getShortEdges() const {
+	return shortEdges;
+}
+
+// conversion
+
+void PolyFile::toPolyhedron(Polyhedron &p) const {
+	p.vertices.resize(header->vertexTotal);
+	if(isPacked()){
+		for(std::uint32_t v = 0; v < header->vertexTotal; v++) for(int i = 0; i < 3; i++) p.vertices[v][i] = Quantise::fromSnorm(packedVertices[v * 3 + i]) * scale;
+	}
+	else for(std::uint32_t v = 0; v < header->vertexTotal; v++) p.vertices[v] = {vertices[v * 3], vertices[v * 3 + 1], vertices[v * 3 + 2]};
+	p.edges.resize(header->edgeTotal);
+	p.faces.resize(header->faceTotal);
+	if(shortFaceIndices != nullptr){
+		for(std::uint32_t e = 0; e < header->edgeTotal; e++) p.edges[e] = {shortEdges[e * 2], shortEdges[e * 2 + 1]};
+		for(std::uint32_t f = 0; f < header->faceTotal; f++) p.faces[f].assign(shortFaceIndices + faceOffsets[f], shortFaceIndices + faceOffsets[f + 1]);
+	}
+	else{
+		for(std::uint32_t e = 0; e < header->edgeTotal; e++) p.edges[e] = {(int)edges[e * 2], (int)edges[e * 2 + 1]};
+		for(std::uint32_t f = 0; f < header->faceTotal; f++) p.faces[f].assign(faceIndices + faceOffsets[f], faceIndices + faceOffsets[f + 1]);
+	}
+}
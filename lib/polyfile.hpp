@@ -0,0 +1,83 @@
+#ifndef HEADER_POLYFILE
+#define HEADER_POLYFILE
+
+#include "../source/polyhedra.hpp" // polyhedron conversion
+
+#include <string> // file naming & operator streams
+#include <cstdint> // fixed-size fields
+#include <cstddef> // byte sizes
+
+#define POLYFILE_MAGIC 0x594C4F50 // "POLY" in little-endian byte order
+#define POLYFILE_VERSION 1
+#define POLYFILE_VERSION_PACKED 2
+
+// layout: header, float vertices[3V], uint32 faceOffsets[F + 1], uint32 faceIndices[I], uint32 edges[2E], char operators[L]
+// packed: header, float scale, int16 vertices[3V] normalised against scale, int16 padding if V is odd, uint32 faceOffsets[F + 1],
+// then faceIndices[I] & edges[2E] as uint16 when V <= 65536, otherwise uint32, then char operators[L]
+struct PolyFileHeader{
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t vertexTotal, edgeTotal, faceTotal, indexTotal;
+	std::uint32_t operatorLength;
+	std::uint32_t checksum; // FNV-1a over everything after the header
+};
+
+struct PolyChecksum{
+	std::uint32_t hash;
+	PolyChecksum();
+	void add(void const *data, std::size_t bytes);
+};
+
+class PolyFile{ // read-only memory-mapped view; pointers stay valid until close
+
+	// mapping
+	void *mapping;
+	std::size_t size;
+#ifdef _WIN32
+	void *file, *view;
+#else
+	int file;
+#endif
+
+	// contents
+	PolyFileHeader const *header;
+	float const *vertices;
+	std::uint32_t const *faceOffsets, *faceIndices, *edges;
+	float scale;
+	std::int16_t const *packedVertices;
+	std::uint16_t const *shortFaceIndices, *shortEdges;
+	char const *operators;
+
+	// usage
+public:
+	PolyFile();
+	~PolyFile();
+	PolyFile(PolyFile const &) = delete;
+	PolyFile &operator=(PolyFile const &) = delete;
+	bool open(std::string const &fileName, bool isVerified = true);
+	void close();
+	bool isOpen() const;
+
+	// zero-copy access
+	std::uint32_t getVertexTotal() const;
+	std::uint32_t getEdgeTotal() const;
+	std::uint32_t getFaceTotal() const;
+	std::uint32_t getIndexTotal() const;
+	float const *getVertices() const; // x y z per vertex, null when packed
+	std::uint32_t const *getFaceOffsets() const; // face f spans getFaceIndices()[offsets[f]] to [offsets[f + 1]]
+	std::uint32_t const *getFaceIndices() const; // null when packed with short indices
+	std::uint32_t const *getEdges() const; // vertex pair per edge, null when packed with short indices
+	std::string getOperators() const;
+	
+	// packed access
+	bool isPacked() const;
+	float getScale() const; // packed vertices times this are positions
+	std::int16_t const *getPackedVertices() const; // x y z per vertex
+	std::uint16_t const *getShortFaceIndices() const; // null unless packed with 65536 vertices or fewer
+	std::uint16_t const *getShortEdges() const;
+
+	// conversion
+	void toPolyhedron(Polyhedron &p) const;
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include "profiler.hpp"
+#include "../utils/debug.hpp"
+
+#include <stdio.h> // report writing
+
+namespace{
+	char const *const phaseNames[ProfilePhaseTotal] = {"input", "mutate", "upload", "draw"};
+}
+
+// frame methods
+
+double ProfileFrame::getSeconds(ProfilePhase phase) const {
+	double total = 0;
+	for(ProfileSpan const &span : spans[phase]) total += span.seconds;
+	return total;
+}
+
+// profiler methods
+
+Profiler::Profiler() : origin(std::chrono::steady_clock::now()) {
+	starts.fill(0);
+	frames.push_back(ProfileFrame{0, 0, 0, {}, -1, 0});
+}
+
+double Profiler::getNow() const {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void Profiler::begin(ProfilePhase phase){
+	starts[phase] = getNow();
+}
+
+void Profiler::end(ProfilePhase phase){
+	double const now = getNow();
+	frames.back().spans[phase].push_back({starts[phase], now - starts[phase]});
+}
+
+void Profiler::beginGPU(){
+	gpu.begin(frames.back().frame);
+}
+
+void Profiler::endGPU(){
+	gpu.end();
+}
+
+void Profiler::endFrame(std::size_t calls){
+	double const now = getNow();
+	ProfileFrame &frame = frames.back();
+	frame.seconds = now - frame.start;
+	frame.calls = calls;
+	collect();
+	frames.push_back(ProfileFrame{frame.frame + 1, now, 0, {}, -1, 0});
+	if(frames.size() > PROFILER_FRAMES) frames.pop_front();
+}
+
+void Profiler::collect(){
+	std::size_t tag;
+	double seconds;
+	while(gpu.poll(tag, seconds)){
+		if(tag < frames.front().frame) continue; // frame already dropped from the history
+		frames[tag - frames.front().frame].gpuSeconds = seconds;
+	}
+}
+
+std::string Profiler::getSummary(std::size_t frameTotal) const {
+	std::size_t const closed = frames.size() - 1;
+	if(frameTotal > closed) frameTotal = closed;
+	if(frameTotal == 0) return "";
+	double frameSeconds = 0, gpuSeconds = 0;
+	std::array<double, ProfilePhaseTotal> phaseSeconds = {};
+	std::size_t gpuFrames = 0, calls = 0;
+	for(std::size_t f = closed - frameTotal; f < closed; f++){
+		ProfileFrame const &frame = frames[f];
+		frameSeconds += frame.seconds;
+		for(int p = 0; p < ProfilePhaseTotal; p++) phaseSeconds[p] += frame.getSeconds((ProfilePhase)p);
+		if(frame.gpuSeconds >= 0){
+			gpuSeconds += frame.gpuSeconds;
+			gpuFrames++;
+		}
+		calls += frame.calls;
+	}
+	char text[256];
+	int length = snprintf(text, sizeof(text), "frame %.2f ms", frameSeconds * 1000.0 / frameTotal);
+	for(int p = 0; p < ProfilePhaseTotal; p++)
+		length += snprintf(text + length, sizeof(text) - length, " | %s %.2f", phaseNames[p], phaseSeconds[p] * 1000.0 / frameTotal);
+	snprintf(text + length, sizeof(text) - length, " | gpu %.2f ms | %zu calls", gpuFrames > 0 ? gpuSeconds * 1000.0 / gpuFrames : 0.0, calls / frameTotal);
+	return text;
+}
+
+// writing
+
+bool Profiler::writeCSV(std::string const &fileName) const {
+	FILE *fp = fopen(fileName.c_str(), "w");
+	if(fp == NULL){
+		debug("Error: profile not written", fileName);
+		return false;
+	}
+	fprintf(fp, "frame,start_ms,frame_ms");
+	for(int p = 0; p < ProfilePhaseTotal; p++) fprintf(fp, ",%s_ms", phaseNames[p]);
+	fprintf(fp, ",gpu_ms,gl_calls\n");
+	for(std::size_t f = 0; f + 1 < frames.size(); f++){
+		ProfileFrame const &frame = frames[f];
+		fprintf(fp, "%zu,%.4f,%.4f", frame.frame, frame.start * 1000.0, frame.seconds * 1000.0);
+		for(int p = 0; p < ProfilePhaseTotal; p++) fprintf(fp, ",%.4f", frame.getSeconds((ProfilePhase)p) * 1000.0);
+		if(frame.gpuSeconds >= 0) fprintf(fp, ",%.4f", frame.gpuSeconds * 1000.0);
+		else fprintf(fp, ",");
+		fprintf(fp, ",%zu\n", frame.calls);
+	}
+	fclose(fp);
+	return true;
+}
+
+bool Profiler::writeTrace(std::string const &fileName) const { // complete events in microseconds; GPU spans start with their frame's draw phase
+	FILE *fp = fopen(fileName.c_str(), "w");
+	if(fp == NULL){
+		debug("Error: profile not written", fileName);
+		return false;
+	}
+	fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+	fprintf(fp, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"cpu\"}},\n");
+	fprintf(fp, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, \"args\": {\"name\": \"gpu\"}}");
+	for(std::size_t f = 0; f + 1 < frames.size(); f++){
+		ProfileFrame const &frame = frames[f];
+		for(int p = 0; p < ProfilePhaseTotal; p++)
+			for(ProfileSpan const &span : frame.spans[p])
+				fprintf(fp, ",\n{\"name\": \"%s\", \"cat\": \"cpu\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": %.3f, \"dur\": %.3f, \"args\": {\"frame\": %zu}}",
+					phaseNames[p], span.start * 1e6, span.seconds * 1e6, frame.frame);
+		if(frame.gpuSeconds >= 0){
+			double const start = frame.spans[ProfileDraw].empty() ? frame.start : frame.spans[ProfileDraw].front().start;
+			fprintf(fp, ",\n{\"name\": \"gpu\", \"cat\": \"gpu\", \"ph\": \"X\", \"pid\": 1, \"tid\": 2, \"ts\": %.3f, \"dur\": %.3f, \"args\": {\"frame\": %zu}}",
+				start * 1e6, frame.gpuSeconds * 1e6, frame.frame);
+		}
+	}
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+	return true;
+}
+
+bool Profiler::write(std::string const &fileName) const {
+	std::string const extension = ".json";
+	if(fileName.size() >= extension.size() && fileName.compare(fileName.size() - extension.size(), extension.size(), extension) == 0)
+		return writeTrace(fileName);
+	return writeCSV(fileName);
+}
@@ -0,0 +1,64 @@
+#ifndef HEADER_PROFILER
+#define HEADER_PROFILER
+
+#include "shader.hpp" // GPU timer queries
+
+#include <deque> // bounded frame history
+#include <vector> // phase spans
+#include <array> // per-phase timings
+#include <string> // report text & files
+#include <chrono> // CPU timing
+#include <cstddef> // frame numbering
+
+#define PROFILER_FRAMES 8192 // newest frames kept for dumping
+
+enum ProfilePhase{
+	ProfileInput, // camera & view controls
+	ProfileMutate, // operator results & mesh submission
+	ProfileUpload, // staged buffer writes
+	ProfileDraw, // clearing, drawing & swapping
+	ProfilePhaseTotal
+};
+
+struct ProfileSpan{
+	double start, seconds; // since the profiler began
+};
+
+struct ProfileFrame{ // one displayed frame, with the input ticks run since the previous one
+	std::size_t frame;
+	double start, seconds;
+	std::array<std::vector<ProfileSpan>, ProfilePhaseTotal> spans;
+	double gpuSeconds; // -1 until its query is read back, or if it went untimed
+	std::size_t calls; // GL calls
+	double getSeconds(ProfilePhase phase) const;
+};
+
+// CPU phases are timed by steady clock & GPU work by timer queries, collected frames later without stalling;
+// the history can be summarised for display or dumped as CSV, or as a Chrome trace for chrome://tracing & Perfetto
+class Profiler{
+
+	// timing
+	std::chrono::steady_clock::time_point origin;
+	std::array<double, ProfilePhaseTotal> starts;
+	TimerQuery gpu;
+	double getNow() const;
+
+	// history
+	std::deque<ProfileFrame> frames; // oldest first, the last one open
+	void collect(); // finished GPU timings into their frames
+
+	// usage
+public:
+	Profiler(); // needs a current GL context
+	void begin(ProfilePhase phase);
+	void end(ProfilePhase phase);
+	void beginGPU(); // around the frame's GL work, one span per frame
+	void endGPU();
+	void endFrame(std::size_t calls); // closes the open frame, opening the next
+	std::string getSummary(std::size_t frameTotal) const; // mean milliseconds over the newest closed frames
+	bool writeCSV(std::string const &fileName) const;
+	bool writeTrace(std::string const &fileName) const;
+	bool write(std::string const &fileName) const; // Chrome trace for .json names, otherwise CSV
+};
+
+#endif
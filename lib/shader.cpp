@@ -1,23 +1,139 @@
 #include "shader.hpp"
 #include "../utils/debug.hpp"
 
+#define COUNTED(call) (CallCounter::calls++, call)
+
+namespace{
+	GLuint boundProgram = 0, boundArray = 0; // skips rebinding the program & vertex array already in use
+	void useProgram(GLuint id){
+		if(id == boundProgram) return;
+		COUNTED(glUseProgram(id));
+		boundProgram = id;
+	}
+	void useArray(GLuint id){
+		if(id == boundArray) return;
+		COUNTED(glBindVertexArray(id));
+		boundArray = id;
+	}
+}
+
+// call counter
+
+std::size_t CallCounter::calls = 0;
+
+std::size_t CallCounter::take(){
+	std::size_t const total = calls;
+	calls = 0;
+	return total;
+}
+
+// timer query
+
+TimerQuery::TimerQuery() : first(0), pending(0), isActive(false) {
+	COUNTED(glGenQueries(TIMER_QUERIES, ids.data()));
+}
+
+TimerQuery::~TimerQuery(){
+	COUNTED(glDeleteQueries(TIMER_QUERIES, ids.data()));
+}
+
+bool TimerQuery::begin(std::size_t tag){
+	if(pending == TIMER_QUERIES) return false;
+	int const q = (first + pending) % TIMER_QUERIES;
+	tags[q] = tag;
+	COUNTED(glBeginQuery(GL_TIME_ELAPSED, ids[q]));
+	isActive = true;
+	return true;
+}
+
+void TimerQuery::end(){
+	if(!isActive) return;
+	COUNTED(glEndQuery(GL_TIME_ELAPSED));
+	isActive = false;
+	pending++;
+}
+
+bool TimerQuery::poll(std::size_t &tag, double &seconds){
+	if(pending == 0) return false;
+	GLint isAvailable = 0;
+	COUNTED(glGetQueryObjectiv(ids[first], GL_QUERY_RESULT_AVAILABLE, &isAvailable));
+	if(!isAvailable) return false;
+	GLuint64 nanoseconds = 0;
+	COUNTED(glGetQueryObjectui64v(ids[first], GL_QUERY_RESULT, &nanoseconds));
+	tag = tags[first];
+	seconds = nanoseconds * 1e-9;
+	first = (first + 1) % TIMER_QUERIES;
+	pending--;
+	return true;
+}
+
 // buffer
-Buffer::Buffer(BufferFrequency frequency, GLvoid const *data, GLsizeiptr dataSize, GLsizeiptr size){
-	glGenBuffers(1, &id);
-	glBindBuffer(GL_ARRAY_BUFFER, id);
-	glBufferData(GL_ARRAY_BUFFER, size, NULL, frequency);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, data);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+Buffer::Buffer(BufferFrequency f, GLvoid const *data, GLsizeiptr dataSize, GLsizeiptr size) : capacity(0), frequency(f) {
+	COUNTED(glGenBuffers(1, &id));
+	COUNTED(glBindBuffer(GL_ARRAY_BUFFER, id));
+	allocate(size > dataSize ? size : dataSize);
+	if(dataSize > 0) COUNTED(glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, data));
+	COUNTED(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
 
 Buffer::~Buffer(){
-	glDeleteBuffers(1, &id);
+	COUNTED(glDeleteBuffers(1, &id));
 }
 
-void Buffer::update(GLvoid const *data, GLsizeiptr size, GLintptr offset) const {
-	glBindBuffer(GL_ARRAY_BUFFER, id);
-	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+void Buffer::allocate(GLsizeiptr size){ // expects the buffer bound to GL_ARRAY_BUFFER
+	COUNTED(glBufferData(GL_ARRAY_BUFFER, size, NULL, frequency));
+	capacity = size;
+}
+
+void Buffer::reserve(GLsizeiptr size){
+	GLsizeiptr resize = capacity;
+	if(size > capacity) resize = size > capacity * BUFFER_GROWTH ? size : capacity * BUFFER_GROWTH;
+	else if(size * BUFFER_SHRINK < capacity) resize = size * BUFFER_GROWTH;
+	COUNTED(glBindBuffer(GL_ARRAY_BUFFER, id));
+	allocate(resize); // same-size reallocation orphans the old storage, so pending draws don't stall the upload
+	COUNTED(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+void Buffer::update(GLvoid const *data, GLsizeiptr size, GLintptr offset){
+	if(offset + size > capacity){ // grow through a temporary copy, keeping this buffer's name
+		GLsizeiptr const resize = offset + size > capacity * BUFFER_GROWTH ? offset + size : capacity * BUFFER_GROWTH;
+		GLsizeiptr const kept = offset < capacity ? offset : capacity;
+		GLuint copy = 0;
+		if(kept > 0){
+			COUNTED(glGenBuffers(1, &copy));
+			COUNTED(glBindBuffer(GL_COPY_WRITE_BUFFER, copy));
+			COUNTED(glBufferData(GL_COPY_WRITE_BUFFER, kept, NULL, GL_STREAM_COPY));
+			COUNTED(glBindBuffer(GL_COPY_READ_BUFFER, id));
+			COUNTED(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, kept));
+		}
+		COUNTED(glBindBuffer(GL_ARRAY_BUFFER, id));
+		allocate(resize);
+		if(kept > 0){
+			COUNTED(glBindBuffer(GL_COPY_READ_BUFFER, copy));
+			COUNTED(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ARRAY_BUFFER, 0, 0, kept));
+			COUNTED(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+			COUNTED(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+			COUNTED(glDeleteBuffers(1, &copy));
+		}
+		debug("buffer grown", resize);
+	}
+	COUNTED(glBindBuffer(GL_ARRAY_BUFFER, id));
+	COUNTED(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+	COUNTED(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+void Buffer::copy(Buffer const &source, GLintptr sourceOffset, GLsizeiptr size, GLintptr offset){
+	COUNTED(glBindBuffer(GL_COPY_READ_BUFFER, source.id));
+	COUNTED(glBindBuffer(GL_COPY_WRITE_BUFFER, id));
+	COUNTED(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceOffset, offset, size));
+	COUNTED(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+	COUNTED(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+}
+
+// uniform buffer
+
+UniformBuffer::UniformBuffer(GLsizeiptr size, GLuint b) : Buffer(BufferDynamic, NULL, 0, size), binding(b) {
+	COUNTED(glBindBufferBase(GL_UNIFORM_BUFFER, binding, id));
 }
 
 // index
@@ -29,13 +145,26 @@ Index::Index(Buffer const &b, IndexType t, GLsizei s, GLvoid *o) :
 	buffer(b.id), type(t), stride(s), offset(o), size(1), normal(IndexUnchanged) {}
 
 void Index::bind(GLenum target) const {
-	glBindBuffer(target, buffer);
+	COUNTED(glBindBuffer(target, buffer));
 }
 
 void Index::attribute(GLenum target, GLuint index) const {
 	bind(target);
-	glVertexAttribPointer(index, size, type, normal, stride, offset);
-	glEnableVertexAttribArray(index);
+	COUNTED(glVertexAttribPointer(index, size, type, normal, stride, offset));
+	COUNTED(glEnableVertexAttribArray(index));
+}
+
+// texture buffer
+
+TextureBuffer::TextureBuffer(Buffer const &b, TextureFormat f, GLuint unit){
+	COUNTED(glGenTextures(1, &id));
+	COUNTED(glActiveTexture(GL_TEXTURE0 + unit));
+	COUNTED(glBindTexture(GL_TEXTURE_BUFFER, id));
+	COUNTED(glTexBuffer(GL_TEXTURE_BUFFER, f, b.id)); // follows the buffer's storage as it grows
+}
+
+TextureBuffer::~TextureBuffer(){
+	COUNTED(glDeleteTextures(1, &id));
 }
 
 // shader
@@ -45,17 +174,17 @@ Shader::Shader() : id(GL_INVALID_ENUM) {}
 Shader::Shader(ShaderType t, std::vector<const char*> src){
 	GLint status;
 	GLchar infoLog[1024];
-	id = glCreateShader(t);
-	glShaderSource(id, src.size(), src.data(), 0);
-	glCompileShader(id);
-	if(!(glGetShaderiv(id, GL_COMPILE_STATUS, &status), status)){
-		glGetShaderInfoLog(id, sizeof(infoLog), NULL, infoLog);
+	id = COUNTED(glCreateShader(t));
+	COUNTED(glShaderSource(id, src.size(), src.data(), 0));
+	COUNTED(glCompileShader(id));
+	if(!(COUNTED(glGetShaderiv(id, GL_COMPILE_STATUS, &status)), status)){
+		COUNTED(glGetShaderInfoLog(id, sizeof(infoLog), NULL, infoLog));
 		debug("Error: shader compile error", infoLog);
 	}
 }
 
 Shader::~Shader(){
-	if(id != GL_INVALID_ENUM) glDeleteShader(id);
+	if(id != GL_INVALID_ENUM) COUNTED(glDeleteShader(id));
 }
 
 Shader& Shader::operator=(Shader&& s){
@@ -66,10 +195,16 @@ Shader& Shader::operator=(Shader&& s){
 
 // data
 
+DataInt::DataInt(int x) : data(x) {}
+
+void DataInt::pass(GLint l) const {
+	COUNTED(glUniform1i(l, data));
+}
+
 DataFloat3::DataFloat3(float x1, float x2, float x3) : data{x1, x2, x3} {}
 
 void DataFloat3::pass(GLint l) const {
-	glUniform3fv(l, 1, (GLfloat*)&data);
+	COUNTED(glUniform3fv(l, 1, (GLfloat*)&data));
 }
 
 DataMatrix4::DataMatrix4(std::array<float, 16> const &x, DataTranspose t) : transpose(t) {
@@ -77,7 +212,7 @@ DataMatrix4::DataMatrix4(std::array<float, 16> const &x, DataTranspose t) : tran
 }
 
 void DataMatrix4::pass(GLint l) const {
-	glUniformMatrix4fv(l, 1, GL_FALSE, (GLfloat*)&data);
+	COUNTED(glUniformMatrix4fv(l, 1, GL_FALSE, (GLfloat*)&data));
 }
 
 // program
@@ -85,42 +220,67 @@ void DataMatrix4::pass(GLint l) const {
 Program::Program(std::vector<Shader*> const &s){
 	GLint status;
 	GLchar infoLog[1024];
-	if((id = glCreateProgram()) == 0)
+	if((id = COUNTED(glCreateProgram())) == 0)
 		debug("Error: program not created");
-	for(Shader const *shader : s) glAttachShader(id, shader->id);
-	glLinkProgram(id);
-	if(!(glGetProgramiv(id, GL_LINK_STATUS, &status), status)){
-		glGetProgramInfoLog(id, sizeof(infoLog), NULL, infoLog);
+	for(Shader const *shader : s) COUNTED(glAttachShader(id, shader->id));
+	COUNTED(glLinkProgram(id));
+	if(!(COUNTED(glGetProgramiv(id, GL_LINK_STATUS, &status)), status)){
+		COUNTED(glGetProgramInfoLog(id, sizeof(infoLog), NULL, infoLog));
 		debug("Error: program not linked", infoLog);
 	}
+	
+	// uniform locations, excluding block members which have none
+	GLint uniformTotal = 0;
+	COUNTED(glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &uniformTotal));
+	for(GLint u = 0; u < uniformTotal; u++){
+		GLchar name[256];
+		GLsizei length;
+		GLint size;
+		GLenum type;
+		COUNTED(glGetActiveUniform(id, u, sizeof(name), &length, &size, &type, name));
+		std::string tag(name, length);
+		if(tag.size() > 3 && tag.compare(tag.size() - 3, 3, "[0]") == 0) tag.erase(tag.size() - 3); // arrays by their plain name
+		GLint const location = COUNTED(glGetUniformLocation(id, name));
+		if(location != -1) locations[tag] = location;
+	}
 }
 
 Program::~Program(){
-	glDeleteProgram(id);
+	if(boundProgram == id) boundProgram = 0;
+	COUNTED(glDeleteProgram(id));
 }
 
 void Program::setUniform(const GLchar *tag, Data const &&d) const {
-	GLint location = glGetUniformLocation(id, tag);
-	if(location == -1){
+	std::unordered_map<std::string, GLint>::const_iterator location = locations.find(tag);
+	if(location == locations.end()){
 		debug("Error: uniform tag not accepted", tag);
 		return;
 	}
-	glUseProgram(id);
-	d.pass(location);
-	glUseProgram(0);
+	useProgram(id);
+	d.pass(location->second);
+}
+
+void Program::setBlock(const GLchar *tag, UniformBuffer const &b) const {
+	GLuint const block = COUNTED(glGetUniformBlockIndex(id, tag));
+	if(block == GL_INVALID_INDEX){
+		debug("Error: uniform block tag not accepted", tag);
+		return;
+	}
+	COUNTED(glUniformBlockBinding(id, block, b.binding));
 }
 
 // draw
 
 DrawArray::DrawArray(DrawMode m, std::vector<Index*> const &ivs, GLsizei n) : mode(m), count(n) {
-	glGenVertexArrays(1, &id);
-	glBindVertexArray(id);
+	COUNTED(glGenVertexArrays(1, &id));
+	useArray(id);
 	for(int i = 0; i < ivs.size(); i++) ivs[i]->attribute(GL_ARRAY_BUFFER, i);
-	glBindVertexArray(0);
+	useArray(0);
 }
 
 DrawArray::~DrawArray(){
-	glDeleteVertexArrays(1, &id);
+	if(boundArray == id) boundArray = 0;
+	COUNTED(glDeleteVertexArrays(1, &id));
 }
 
 void DrawArray::recount(GLsizei n){
@@ -128,18 +288,55 @@ void DrawArray::recount(GLsizei n){
 }
 
 DrawElements::DrawElements(DrawMode m, std::vector<Index*> const &ivs, Index const &ie, GLsizei n) : DrawArray(m, ivs, n), type(ie.type) {
-	glBindVertexArray(id);
+	useArray(id);
 	ie.bind(GL_ELEMENT_ARRAY_BUFFER);
-	glBindVertexArray(0);
+	useArray(0);
+}
+
+DrawMultiArray::DrawMultiArray(DrawMode m, std::vector<Index*> const &ivs, GLsizei n) : DrawArray(m, ivs, n), isWhole(true) {}
+
+void DrawMultiArray::range(std::vector<std::array<int, 2>> const &ranges, int scale){
+	firsts.clear();
+	counts.clear();
+	for(std::array<int, 2> const &r : ranges){
+		firsts.push_back(r[0] * scale);
+		counts.push_back(r[1] * scale);
+	}
+	isWhole = false;
+}
+
+void DrawMultiArray::whole(){
+	isWhole = true;
+}
+
+DrawMultiElements::DrawMultiElements(DrawMode m, std::vector<Index*> const &ivs, Index const &ie, GLsizei n) : DrawElements(m, ivs, ie, n), isWhole(true) {}
+
+void DrawMultiElements::range(std::vector<std::array<int, 2>> const &ranges, int scale){
+	std::size_t const size = type == GL_UNSIGNED_BYTE ? 1 : (type == GL_UNSIGNED_SHORT ? 2 : 4);
+	offsets.clear();
+	counts.clear();
+	for(std::array<int, 2> const &r : ranges){
+		offsets.push_back((GLvoid const*)(r[0] * scale * size));
+		counts.push_back(r[1] * scale);
+	}
+	isWhole = false;
+}
+
+void DrawMultiElements::whole(){
+	isWhole = true;
+}
+
+void DrawElements::retype(IndexType t){
+	type = t;
 }
 
 DrawInstanced::DrawInstanced(GLuint id, std::vector<Index*> const &ivs, std::vector<Index*> const &iis, GLsizei in) : instanceCount(in) {
-	glBindVertexArray(id);
+	useArray(id);
 	for(int i = 0; i < iis.size(); i++){
 		iis[i]->attribute(GL_ARRAY_BUFFER, ivs.size() + i);
-		glVertexAttribDivisor(ivs.size() + i, 1);
+		COUNTED(glVertexAttribDivisor(ivs.size() + i, 1));
 	}
-	glBindVertexArray(0);
+	useArray(0);
 }
 
 DrawInstancedArray::DrawInstancedArray(DrawMode m, std::vector<Index*> const &ivs, GLsizei n, std::vector<Index*> const &iis, GLsizei in) : 
@@ -149,29 +346,37 @@ DrawInstancedElements::DrawInstancedElements(DrawMode m, std::vector<Index*> con
 	DrawElements(m, ivs, ie, n), DrawInstanced(id, ivs, iis, in) {}
 
 void DrawArray::call() const {
-	glDrawArrays(mode, 0, count);
+	COUNTED(glDrawArrays(mode, 0, count));
 }
 
 void DrawElements::call() const {
-	glDrawElements(mode, count, type, 0);
+	COUNTED(glDrawElements(mode, count, type, 0));
+}
+
+void DrawMultiArray::call() const {
+	if(isWhole) DrawArray::call();
+	else if(!counts.empty()) COUNTED(glMultiDrawArrays(mode, firsts.data(), counts.data(), counts.size()));
+}
+
+void DrawMultiElements::call() const {
+	if(isWhole) DrawElements::call();
+	else if(!counts.empty()) COUNTED(glMultiDrawElements(mode, counts.data(), type, offsets.data(), counts.size()));
 }
 
 void DrawInstancedArray::call() const {
-	glDrawArraysInstanced(mode, 0, count, instanceCount);
+	COUNTED(glDrawArraysInstanced(mode, 0, count, instanceCount));
 }
 
 void DrawInstancedElements::call() const {
-	glDrawElementsInstanced(mode, count, type, 0, instanceCount);
+	COUNTED(glDrawElementsInstanced(mode, count, type, 0, instanceCount));
 }
 
 // renderer
 
 Renderer::Renderer(Program const &p, DrawArray const &d) : program(p.id), vao(d.id), draw(d) {}
 
-void Renderer::display() const {
-	glUseProgram(program);
-	glBindVertexArray(vao);
+void Renderer::display() const { // program & vertex array stay bound for the next frame
+	useProgram(program);
+	useArray(vao);
 	draw.call();
-	glBindVertexArray(0);
-	glUseProgram(0);
 }
\ No newline at end of file
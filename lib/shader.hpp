@@ -5,6 +5,9 @@
 
 #include <vector> // argument handling
 #include <array> // data storage & passing
+#include <string> // uniform names
+#include <unordered_map> // uniform location caching
+#include <cstddef> // call counts
 
 // overview
 
@@ -12,9 +15,13 @@ struct Shader; // shader compilation
 struct Program; // program compilation & shader linking
 struct Index; // buffer indexing
 struct Buffer; // buffer data
+struct UniformBuffer; // uniform block data shared between programs
 struct Data; // uniform data
+struct TextureBuffer; // buffer data read by index in shaders
 struct DrawArray; // drawing operation & attribute binding
 struct Renderer; // displaying
+struct CallCounter; // GL call counting
+struct TimerQuery; // GPU timing
 
 // data
 
@@ -32,7 +39,10 @@ enum BufferFrequency{
 
 enum IndexType{
 	IndexFloat = GL_FLOAT, 
-	IndexUint = GL_UNSIGNED_INT
+	IndexUint = GL_UNSIGNED_INT, 
+	IndexShort = GL_SHORT, // packed positions & normals, normalised
+	IndexUshort = GL_UNSIGNED_SHORT, // element indices below 65536 vertices
+	IndexUbyte = GL_UNSIGNED_BYTE // packed barycentrics, normalised
 };
 
 enum IndexNormal{
@@ -40,6 +50,10 @@ enum IndexNormal{
 	IndexNormalised = GL_TRUE
 };
 
+enum TextureFormat{
+	TextureFloat4 = GL_RGBA32F
+};
+
 enum DataTranspose{
 	DataUnchanged = GL_FALSE, 
 	DataTransposed = GL_TRUE
@@ -53,11 +67,25 @@ enum DrawMode{
 
 // classes
 
-struct Buffer{
+#define BUFFER_GROWTH 2 // capacity multiplier when data outgrows a buffer
+#define BUFFER_SHRINK 4 // capacity divisor below which a reserved buffer is reallocated smaller
+
+struct Buffer{ // the buffer name never changes, so indices & draw arrays stay bound across growth
 	GLuint id;
-	Buffer(BufferFrequency frequency, GLvoid const *data, GLsizeiptr dataSize, GLsizeiptr size);
+	GLsizeiptr capacity;
+	BufferFrequency frequency;
+	Buffer(BufferFrequency f, GLvoid const *data, GLsizeiptr dataSize, GLsizeiptr size = 0);
 	~Buffer();
-	void update(GLvoid const *data, GLsizeiptr size, GLintptr offset) const;
+	void reserve(GLsizeiptr size); // orphans the storage, discarding contents, at a geometric capacity of at least size
+	void update(GLvoid const *data, GLsizeiptr size, GLintptr offset); // grows, keeping existing contents, when written past capacity
+	void copy(Buffer const &source, GLintptr sourceOffset, GLsizeiptr size, GLintptr offset); // GPU-side copy, without growing
+private:
+	void allocate(GLsizeiptr size);
+};
+
+struct UniformBuffer : Buffer{ // std140 block data, bound once to its binding point for every program reading it
+	GLuint binding;
+	UniformBuffer(GLsizeiptr size, GLuint b);
 };
 
 struct Index{
@@ -73,6 +101,12 @@ struct Index{
 	void attribute(GLenum target, GLuint index) const;
 };
 
+struct TextureBuffer{ // stays bound to its unit, as no other textures are used
+	GLuint id;
+	TextureBuffer(Buffer const &b, TextureFormat f, GLuint unit);
+	~TextureBuffer();
+};
+
 struct Shader{
 	GLuint id;
 	Shader();
@@ -82,6 +116,11 @@ struct Shader{
 };
 
 struct Data{ virtual void pass(GLint l) const = 0; };
+struct DataInt : Data{
+	GLint data;
+	DataInt(int x);
+	void pass(GLint l) const;
+};
 struct DataFloat3 : Data{
 	GLfloat data[3];
 	DataFloat3(float x1, float x2, float x3);
@@ -96,9 +135,11 @@ struct DataMatrix4 : Data{
 
 struct Program{
 	GLuint id;
+	std::unordered_map<std::string, GLint> locations; // active uniforms, resolved once at link
 	Program(std::vector<Shader*> const &s);
 	~Program();
-	void setUniform(const GLchar *tag, Data const &&d) const;
+	void setUniform(const GLchar *tag, Data const &&d) const; // leaves the program in use, so repeated calls don't rebind
+	void setBlock(const GLchar *tag, UniformBuffer const &b) const; // once; the block then follows the buffer's contents
 };
 
 struct DrawArray{
@@ -114,6 +155,25 @@ struct DrawElements : DrawArray{
 	GLenum type;
 	DrawElements(DrawMode m, std::vector<Index*> const &ivs, Index const &ie, GLsizei n);
 	void call() const;
+	void retype(IndexType t); // element width, following meshes whose indices are narrowed
+};
+struct DrawMultiArray : DrawArray{ // only the given ranges, in one call, until drawn whole again
+	std::vector<GLint> firsts;
+	std::vector<GLsizei> counts;
+	bool isWhole;
+	DrawMultiArray(DrawMode m, std::vector<Index*> const &ivs, GLsizei n);
+	void range(std::vector<std::array<int, 2>> const &ranges, int scale); // {first, count} ranges, in units of scale vertices
+	void whole();
+	void call() const;
+};
+struct DrawMultiElements : DrawElements{
+	std::vector<GLvoid const*> offsets;
+	std::vector<GLsizei> counts;
+	bool isWhole;
+	DrawMultiElements(DrawMode m, std::vector<Index*> const &ivs, Index const &ie, GLsizei n);
+	void range(std::vector<std::array<int, 2>> const &ranges, int scale);
+	void whole();
+	void call() const;
 };
 struct DrawInstanced{
 	GLsizei instanceCount;
@@ -135,4 +195,23 @@ struct Renderer{
 	void display() const;
 };
 
+#define TIMER_QUERIES 4 // GPU timings in flight before the oldest must be read back
+
+struct TimerQuery{ // GL_TIME_ELAPSED queries in a ring, read back frames later so the CPU never waits on the GPU
+	std::array<GLuint, TIMER_QUERIES> ids;
+	std::array<std::size_t, TIMER_QUERIES> tags; // caller's tag per query, e.g. its frame
+	int first, pending;
+	bool isActive;
+	TimerQuery();
+	~TimerQuery();
+	bool begin(std::size_t tag); // false while every query is still in flight, leaving this span untimed
+	void end();
+	bool poll(std::size_t &tag, double &seconds); // the oldest finished timing, if any
+};
+
+struct CallCounter{ // GL calls made through this library
+	static std::size_t calls;
+	static std::size_t take(); // calls since the last take, e.g. per displayed frame
+};
+
 #endif
\ No newline at end of file
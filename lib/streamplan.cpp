@@ -0,0 +1,184 @@
+#include "streamplan.hpp"
+#include "topology.hpp"
+#include "canonical.hpp"
+#include "../utils/notation.hpp"
+
+// compilation methods
+
+StreamPlan::StreamPlan(std::string const &operators) : seed(0), operatorTotal(0), isValid(false), cost{0, 0, 0, 0.} {
+	if(operators.empty() || !Notation::expand(operators.back()).empty()) return;
+
+	// primitives in application order, each compound's expansion read right-to-left
+	for(std::size_t s = operators.size() - 1; s-- > 0;){
+		std::string const primitives = Notation::expand(operators[s]);
+		if(primitives.empty()) return;
+		for(std::size_t p = primitives.size(); p-- > 0;) steps.push_back({primitives[p], 1});
+	}
+	operatorTotal = steps.size();
+
+	// seed
+	std::vector<Polyhedron> history = PolyhedronFactory::make(operators.substr(operators.size() - 1));
+	if(history.empty()) return;
+	seed = operators.back();
+	base = std::move(history.back());
+	rewrite(steps);
+	fuse();
+	estimate();
+	isValid = true;
+}
+
+void StreamPlan::rewrite(std::vector<StreamStep> &program){ // peephole rewriting on a stack, so each rewrite can expose the next
+	std::size_t relaxed = 0; // steps before the last c, whose embedding that c replaces
+	for(std::size_t s = program.size(); s-- > 0;){
+		if(program[s].op == 'c'){
+			relaxed = s;
+			break;
+		}
+	}
+	std::vector<StreamStep> kept;
+	kept.reserve(program.size());
+	for(std::size_t s = 0; s < program.size(); s++){
+		StreamStep const &step = program[s];
+		if(kept.empty()){
+			kept.push_back(step);
+			continue;
+		}
+		StreamStep &last = kept.back();
+		if(last.op == 'c' && step.op == 'c') last.passes += step.passes;
+		else if(s >= relaxed) kept.push_back(step); // dd & ad keep the graph but not the positions
+		else if(last.op == 'd' && step.op == 'd') kept.pop_back(); // dd
+		else if(last.op == 'd' && step.op == 'a') last = step; // ad; gd is g's mirror image, so stays
+		else kept.push_back(step);
+	}
+	program = std::move(kept);
+}
+
+void StreamPlan::fuse(){ // fewest steps from each step onwards, matching each compound's own primitives
+	std::string const fused = "tesmb"; // compounds Topology::mutate builds in one pass
+	std::vector<std::vector<StreamStep>> patterns(fused.size());
+	for(std::size_t c = 0; c < fused.size(); c++){
+		std::string const primitives = Notation::expand(fused[c]);
+		for(std::size_t p = primitives.size(); p-- > 0;) patterns[c].push_back({primitives[p], 1});
+	}
+	std::size_t const n = steps.size();
+	std::vector<std::size_t> fewest(n + 1, 0);
+	std::vector<int> choices(n, -1);
+	for(std::size_t s = n; s-- > 0;){
+		fewest[s] = fewest[s + 1] + 1;
+		for(std::size_t c = 0; c < patterns.size(); c++){
+			std::size_t const length = patterns[c].size();
+			if(s + length > n || fewest[s + length] + 1 >= fewest[s]) continue;
+			std::size_t l = 0;
+			while(l < length && steps[s + l].op == patterns[c][l].op) l++;
+			if(l < length) continue;
+			fewest[s] = fewest[s + length] + 1;
+			choices[s] = c;
+		}
+	}
+	std::vector<StreamStep> folded;
+	for(std::size_t s = 0; s < n;){
+		if(choices[s] == -1) folded.push_back(steps[s++]);
+		else{
+			folded.push_back({fused[choices[s]], 1});
+			s += patterns[choices[s]].size();
+		}
+	}
+	steps = std::move(folded);
+}
+
+void StreamPlan::estimate(){ // V - E + F is kept by every operator
+	std::size_t v = base.vertices.size(), e = base.edges.size(), f = base.faces.size();
+	double work = 0.;
+	for(StreamStep const &step : steps){
+		std::size_t const pv = v, pe = e, pf = f;
+		switch(step.op){
+			case 'd': v = pf; f = pv; break;
+			case 'a': v = pe; e = 2 * pe; f = pv + pf; break;
+			case 'k': v = pv + pf; e = 3 * pe; f = 2 * pe; break;
+			case 'g': v = pv + pf + 2 * pe; e = 5 * pe; f = 2 * pe; break;
+			case 't': v = 2 * pe; e = 3 * pe; f = pf + pv; break;
+			case 'e': v = 2 * pe; e = 4 * pe; f = pf + pv + pe; break;
+			case 's': v = 2 * pe; e = 5 * pe; f = pf + pv + 2 * pe; break;
+			case 'm': v = pv + pf + pe; e = 6 * pe; f = 4 * pe; break;
+			case 'b': v = 4 * pe; e = 6 * pe; f = pf + pv + pe; break;
+			case 'c': work += (double)step.passes * STREAM_CANONICAL_WEIGHT * (v + e + f); continue;
+		}
+		work += v + e + f;
+	}
+	cost = StreamCost{v, e, f, work};
+}
+
+// usage methods
+
+bool StreamPlan::getValid() const {
+	return isValid;
+}
+
+std::string StreamPlan::getStream() const {
+	std::string stream;
+	for(std::size_t s = steps.size(); s-- > 0;) stream.append(steps[s].passes, steps[s].op);
+	if(seed != 0) stream.push_back(seed);
+	return stream;
+}
+
+std::vector<StreamStep> const &StreamPlan::getSteps() const {
+	return steps;
+}
+
+std::size_t StreamPlan::getOperatorTotal() const {
+	return operatorTotal;
+}
+
+StreamCost const &StreamPlan::getCost() const {
+	return cost;
+}
+
+bool StreamPlan::make(Polyhedron &output) const {
+	if(!isValid) return false;
+	output = base;
+	std::string const stream = getStream();
+	Arena arena;
+	apply(output, stream.substr(0, stream.size() - 1), arena);
+	return true;
+}
+
+void StreamPlan::apply(Polyhedron &polyhedron, std::string const &operators, Arena &arena){
+	Topology topology(&arena);
+	bool isTopology = false;
+	for(std::size_t p = operators.size(); p-- > 0;){
+		if(operators[p] == 'c'){
+			int passes = 1;
+			while(p > 0 && operators[p - 1] == 'c'){
+				passes++;
+				p--;
+			}
+			if(isTopology) topology.toPolyhedron(polyhedron);
+			isTopology = false;
+			Canonical canonical(polyhedron); // single-threaded, as batch workers already run in parallel
+			canonical.relax(CANONICAL_TOLERANCE, passes * CANONICAL_ITERATIONS); // a pass after convergence would stop at once
+			canonical.toPolyhedron(polyhedron);
+			continue;
+		}
+		if(!isTopology) topology = Topology(polyhedron, &arena);
+		isTopology = true;
+		if(topology.mutate(operators[p])) continue;
+		std::string const primitives = Notation::expand(operators[p]);
+		for(std::size_t q = primitives.size(); q-- > 0;) topology.mutate(primitives[q]);
+	}
+	if(isTopology) topology.toPolyhedron(polyhedron);
+}
+
+std::vector<Polyhedron> StreamPlan::history(std::string const &operators){
+	if(operators.empty()) return {};
+	for(char op : operators.substr(0, operators.size() - 1))
+		if(Notation::expand(op).empty()) return PolyhedronFactory::make(operators); // as batches do with unreadable streams
+	std::vector<Polyhedron> shapes = PolyhedronFactory::make(operators.substr(operators.size() - 1));
+	if(shapes.empty()) return shapes;
+	Arena arena;
+	for(std::size_t s = operators.size() - 1; s-- > 0;){ // one shape per operator, so each can be undone
+		shapes.push_back(shapes.back());
+		apply(shapes.back(), operators.substr(s, 1), arena);
+		arena.reset();
+	}
+	return shapes;
+}
@@ -0,0 +1,55 @@
+#ifndef HEADER_STREAMPLAN
+#define HEADER_STREAMPLAN
+
+#include "../source/polyhedra.hpp" // polyhedron generation
+#include "arena.hpp" // intermediate storage
+
+#include <vector> // operator steps
+#include <string> // operator streams
+#include <cstddef> // element totals
+
+#define STREAM_CANONICAL_WEIGHT 100 // element visits per canonical pass relative to one topology operator, as relaxation runs on the order of a hundred iterations
+
+struct StreamStep{
+	char op; // d a k g c, or a fused compound
+	int passes; // canonical passes merged into a c step, 1 otherwise
+};
+
+struct StreamCost{
+	std::size_t vertices, edges, faces; // output totals
+	double work; // element visits over every step, for comparing jobs rather than predicting time
+};
+
+// an operator stream compiled ahead of PolyhedronFactory::make: compounds are expanded into primitive steps in application
+// order, adjacent c passes merge into one relaxation, and ahead of a later c, dd cancels and ad becomes a (the same graph,
+// which that c re-embeds; gd stays, as g's mirror image); the fewest steps are then found by folding primitive runs back
+// into the compounds Topology builds in one pass; output totals follow from Euler-preserving counting rules, before anything runs
+class StreamPlan{
+
+	// program
+	char seed;
+	Polyhedron base; // the seed, built once
+	std::vector<StreamStep> steps; // seed's first operator first
+	std::size_t operatorTotal; // primitive steps before optimisation
+	bool isValid;
+
+	// estimate
+	StreamCost cost;
+	static void rewrite(std::vector<StreamStep> &program);
+	void fuse();
+	void estimate();
+
+	// usage
+public:
+	StreamPlan(std::string const &operators); // builds only the seed, to count it
+	bool getValid() const; // false for streams with unknown operators, which are left to the factory
+	std::string getStream() const; // optimised primitives right-to-left, c written once per merged pass so suffixes still key caches
+	std::vector<StreamStep> const &getSteps() const;
+	std::size_t getOperatorTotal() const;
+	StreamCost const &getCost() const;
+	bool make(Polyhedron &output) const;
+	static void apply(Polyhedron &polyhedron, std::string const &operators, Arena &arena); // right-to-left on flat half-edges, other compounds as their primitives, each run of c as one relaxation
+	static std::vector<Polyhedron> history(std::string const &operators); // seed & each operator's result, as PolyhedronFactory::make returns, built by apply like the cache & batches
+};
+
+#endif
@@ -0,0 +1,399 @@
+#include "topology.hpp"
+#include "../utils/debug.hpp"
+
+namespace{
+	std::array<float, 3> lerp(std::array<float, 3> const &a, std::array<float, 3> const &b, float t){
+		return {a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t, a[2] + (b[2] - a[2]) * t};
+	}
+	void addScaled(std::array<float, 3> &sum, std::array<float, 3> const &a, float weight){
+		for(int i = 0; i < 3; i++) sum[i] += a[i] * weight;
+	}
+}
+
+// construction
+
+Topology::Topology(Arena *a) : arena(a), vertices(a), faceOffsets(1, 0, a), origins(a), faceOf(a), twins(a), edgeOf(a), vertexEdges(a), edgeTotal(0) {}
+
+Topology::Topology(Polyhedron const &p, Arena *a) : arena(a), vertices(p.vertices.begin(), p.vertices.end(), a),
+	faceOffsets(a), origins(a), faceOf(a), twins(a), edgeOf(a), vertexEdges(a), edgeTotal(0) {
+	int indexTotal = 0;
+	for(std::vector<int> const &face : p.faces) indexTotal += face.size();
+	faceOffsets.reserve(p.faces.size() + 1);
+	origins.reserve(indexTotal);
+	faceOffsets.push_back(0);
+	for(std::vector<int> const &face : p.faces){
+		origins.insert(origins.end(), face.begin(), face.end());
+		faceOffsets.push_back(origins.size());
+	}
+	link();
+}
+
+Topology::Topology(ArenaVector<std::array<float, 3>> &&vs, ArenaVector<int> &&offsets, ArenaVector<int> &&indices, Arena *a) :
+	arena(a), vertices(std::move(vs)), faceOffsets(std::move(offsets)), origins(std::move(indices)), faceOf(a), twins(a), edgeOf(a), vertexEdges(a), edgeTotal(0) {
+	link();
+}
+
+void Topology::link(){
+	int const halfEdgeTotal = getHalfEdgeTotal();
+	int const vertexTotal = vertices.size();
+
+	// half-edge faces
+	faceOf.resize(halfEdgeTotal);
+	for(int f = 0; f < getFaceTotal(); f++)
+		for(int h = faceOffsets[f]; h < faceOffsets[f + 1]; h++) faceOf[h] = f;
+
+	// outgoing half-edges grouped by origin vertex (counting sort)
+	ArenaVector<int> outOffsets(vertexTotal + 1, 0, arena);
+	for(int h = 0; h < halfEdgeTotal; h++) outOffsets[origins[h] + 1]++;
+	for(int v = 0; v < vertexTotal; v++) outOffsets[v + 1] += outOffsets[v];
+	ArenaVector<int> outgoing(halfEdgeTotal, 0, arena);
+	ArenaVector<int> fill(outOffsets.begin(), outOffsets.end() - 1, arena);
+	for(int h = 0; h < halfEdgeTotal; h++) outgoing[fill[origins[h]]++] = h;
+
+	// twins: the half-edge leaving this one's target back towards its origin
+	twins.assign(halfEdgeTotal, -1);
+	for(int h = 0; h < halfEdgeTotal; h++){
+		int const a = origins[h], b = target(h);
+		for(int o = outOffsets[b]; o < outOffsets[b + 1]; o++){
+			if(target(outgoing[o]) == a){
+				twins[h] = outgoing[o];
+				break;
+			}
+		}
+	}
+
+	// undirected edges
+	edgeOf.assign(halfEdgeTotal, -1);
+	edgeTotal = 0;
+	for(int h = 0; h < halfEdgeTotal; h++){
+		if(edgeOf[h] != -1) continue;
+		edgeOf[h] = edgeTotal;
+		if(twins[h] != -1) edgeOf[twins[h]] = edgeTotal;
+		edgeTotal++;
+	}
+
+	// vertex entry points, preferring a boundary half-edge so rings start at the open side
+	vertexEdges.assign(vertexTotal, -1);
+	for(int h = 0; h < halfEdgeTotal; h++){
+		int &entry = vertexEdges[origins[h]];
+		if(entry == -1 || twins[h] == -1) entry = h; // nothing rotates onto a half-edge without a twin
+	}
+}
+
+void Topology::toPolyhedron(Polyhedron &p) const {
+	p.vertices.assign(vertices.begin(), vertices.end());
+	p.faces.resize(getFaceTotal());
+	for(int f = 0; f < getFaceTotal(); f++) p.faces[f].assign(origins.begin() + faceOffsets[f], origins.begin() + faceOffsets[f + 1]);
+	p.edges.resize(edgeTotal);
+	for(int h = 0; h < getHalfEdgeTotal(); h++){
+		if(twins[h] != -1 && twins[h] < h) continue;
+		p.edges[edgeOf[h]] = {origins[h], target(h)};
+	}
+}
+
+// queries
+
+bool Topology::isClosed() const {
+	for(int h = 0; h < getHalfEdgeTotal(); h++) if(twins[h] == -1) return false;
+	return true;
+}
+
+std::array<float, 3> Topology::getFaceCentre(int f) const {
+	std::array<float, 3> centre = {0, 0, 0};
+	for(int h = faceOffsets[f]; h < faceOffsets[f + 1]; h++)
+		for(int i = 0; i < 3; i++) centre[i] += vertices[origins[h]][i];
+	float const size = getFaceSize(f);
+	for(int i = 0; i < 3; i++) centre[i] /= size;
+	return centre;
+}
+
+void Topology::getVertexRing(int v, std::vector<int> &outgoing) const {
+	outgoing.clear();
+	int const start = vertexEdges[v];
+	if(start == -1) return;
+	int h = start;
+	do{
+		outgoing.push_back(h);
+		h = rotate(h);
+	} while(h != -1 && h != start);
+}
+
+// operators
+
+Topology Topology::dual() const { // face centres, joined anticlockwise around each old vertex
+	ArenaVector<std::array<float, 3>> vs(getFaceTotal(), std::array<float, 3>(), arena);
+	for(int f = 0; f < getFaceTotal(); f++) vs[f] = getFaceCentre(f);
+	ArenaVector<int> offsets(arena), indices(arena);
+	offsets.reserve(vertices.size() + 1);
+	indices.reserve(getHalfEdgeTotal());
+	offsets.push_back(0);
+	std::vector<int> ring;
+	for(int v = 0; v < (int)vertices.size(); v++){
+		getVertexRing(v, ring);
+		for(int h : ring) indices.push_back(faceOf[h]);
+		offsets.push_back(indices.size());
+	}
+	return Topology(std::move(vs), std::move(offsets), std::move(indices), arena);
+}
+
+Topology Topology::ambo() const { // edge midpoints, joined around each old face and each old vertex
+	ArenaVector<std::array<float, 3>> vs(edgeTotal, std::array<float, 3>(), arena);
+	for(int h = 0; h < getHalfEdgeTotal(); h++) vs[edgeOf[h]] = lerp(vertices[origins[h]], vertices[target(h)], .5f);
+	ArenaVector<int> offsets(arena), indices(arena);
+	offsets.reserve(getFaceTotal() + vertices.size() + 1);
+	indices.reserve(getHalfEdgeTotal() * 2);
+	offsets.push_back(0);
+	for(int f = 0; f < getFaceTotal(); f++){
+		for(int h = faceOffsets[f]; h < faceOffsets[f + 1]; h++) indices.push_back(edgeOf[h]);
+		offsets.push_back(indices.size());
+	}
+	std::vector<int> ring;
+	for(int v = 0; v < (int)vertices.size(); v++){
+		getVertexRing(v, ring);
+		for(int h : ring) indices.push_back(edgeOf[h]);
+		offsets.push_back(indices.size());
+	}
+	return Topology(std::move(vs), std::move(offsets), std::move(indices), arena);
+}
+
+Topology Topology::kis() const { // old vertices & face centres, one triangle per old half-edge
+	ArenaVector<std::array<float, 3>> vs(vertices);
+	vs.reserve(vertices.size() + getFaceTotal());
+	for(int f = 0; f < getFaceTotal(); f++) vs.push_back(getFaceCentre(f));
+	ArenaVector<int> offsets(arena), indices(arena);
+	offsets.reserve(getHalfEdgeTotal() + 1);
+	indices.reserve(getHalfEdgeTotal() * 3);
+	offsets.push_back(0);
+	int const centreStart = vertices.size();
+	for(int h = 0; h < getHalfEdgeTotal(); h++){
+		indices.insert(indices.end(), {origins[h], target(h), centreStart + faceOf[h]});
+		offsets.push_back(indices.size());
+	}
+	return Topology(std::move(vs), std::move(offsets), std::move(indices), arena);
+}
+
+Topology Topology::gyro() const { // old vertices, a third along each half-edge & face centres, one pentagon per old half-edge
+	int const thirdStart = vertices.size();
+	int const centreStart = thirdStart + getHalfEdgeTotal();
+	ArenaVector<std::array<float, 3>> vs(vertices);
+	vs.reserve(centreStart + getFaceTotal());
+	for(int h = 0; h < getHalfEdgeTotal(); h++) vs.push_back(lerp(vertices[origins[h]], vertices[target(h)], 1.f / 3.f));
+	for(int f = 0; f < getFaceTotal(); f++) vs.push_back(getFaceCentre(f));
+	ArenaVector<int> offsets(arena), indices(arena);
+	offsets.reserve(getHalfEdgeTotal() + 1);
+	indices.reserve(getHalfEdgeTotal() * 5);
+	offsets.push_back(0);
+	for(int h = 0; h < getHalfEdgeTotal(); h++){
+		if(twins[h] == -1){
+			debug("Error: gyro requires a closed polyhedron");
+			return Topology(arena);
+		}
+		indices.insert(indices.end(), {centreStart + faceOf[h], thirdStart + h, thirdStart + twins[h], target(h), thirdStart + next(h)});
+		offsets.push_back(indices.size());
+	}
+	return Topology(std::move(vs), std::move(offsets), std::move(indices), arena);
+}
+
+// compound operators
+
+Topology Topology::truncate() const { // one vertex per half-edge near its origin, the old faces doubled & a face per old vertex
+	if(!isClosed()){
+		debug("Error: truncate requires a closed polyhedron");
+		return Topology(arena);
+	}
+	ArenaVector<std::array<float, 3>> centres(getFaceTotal(), std::array<float, 3>(), arena);
+	for(int f = 0; f < getFaceTotal(); f++) centres[f] = getFaceCentre(f);
+	ArenaVector<std::array<float, 3>> vs(getHalfEdgeTotal(), std::array<float, 3>(), arena);
+	std::vector<int> ring;
+	for(int v = 0; v < (int)vertices.size(); v++){ // centroid of the kis triangle the dual gives each half-edge
+		getVertexRing(v, ring);
+		std::array<float, 3> mean = {0, 0, 0};
+		for(int h : ring) addScaled(mean, centres[faceOf[h]], 1.f / ring.size());
+		for(int h : ring){
+			addScaled(vs[h], centres[faceOf[h]], 1.f / 3.f);
+			addScaled(vs[h], centres[faceOf[twins[h]]], 1.f / 3.f);
+			addScaled(vs[h], mean, 1.f / 3.f);
+		}
+	}
+	ArenaVector<int> offsets(arena), indices(arena);
+	offsets.reserve(getFaceTotal() + vertices.size() + 1);
+	indices.reserve(getHalfEdgeTotal() * 3);
+	offsets.push_back(0);
+	for(int f = 0; f < getFaceTotal(); f++){
+		for(int h = faceOffsets[f]; h < faceOffsets[f + 1]; h++) indices.insert(indices.end(), {h, twins[h]});
+		offsets.push_back(indices.size());
+	}
+	for(int v = 0; v < (int)vertices.size(); v++){
+		getVertexRing(v, ring);
+		indices.insert(indices.end(), ring.begin(), ring.end());
+		offsets.push_back(indices.size());
+	}
+	return Topology(std::move(vs), std::move(offsets), std::move(indices), arena);
+}
+
+Topology Topology::expand() const { // one vertex per face corner, a face per old face, vertex & edge
+	if(!isClosed()){
+		debug("Error: expand requires a closed polyhedron");
+		return Topology(arena);
+	}
+	ArenaVector<std::array<float, 3>> vs(getHalfEdgeTotal(), std::array<float, 3>(), arena);
+	for(int h = 0; h < getHalfEdgeTotal(); h++){ // midpoint of the two edge midpoints either side of the corner
+		addScaled(vs[h], vertices[origins[h]], .5f);
+		addScaled(vs[h], vertices[target(h)], .25f);
+		addScaled(vs[h], vertices[origins[prev(h)]], .25f);
+	}
+	ArenaVector<int> offsets(arena), indices(arena);
+	offsets.reserve(getFaceTotal() + vertices.size() + edgeTotal + 1);
+	indices.reserve(getHalfEdgeTotal() * 4);
+	offsets.push_back(0);
+	for(int f = 0; f < getFaceTotal(); f++){
+		for(int h = faceOffsets[f]; h < faceOffsets[f + 1]; h++) indices.push_back(h);
+		offsets.push_back(indices.size());
+	}
+	std::vector<int> ring;
+	for(int v = 0; v < (int)vertices.size(); v++){
+		getVertexRing(v, ring);
+		indices.insert(indices.end(), ring.begin(), ring.end());
+		offsets.push_back(indices.size());
+	}
+	for(int h = 0; h < getHalfEdgeTotal(); h++){
+		if(twins[h] < h) continue;
+		indices.insert(indices.end(), {next(h), h, next(twins[h]), twins[h]});
+		offsets.push_back(indices.size());
+	}
+	return Topology(std::move(vs), std::move(offsets), std::move(indices), arena);
+}
+
+Topology Topology::snub() const { // one vertex per half-edge, a face per old face & vertex and two triangles per old edge
+	if(!isClosed()){
+		debug("Error: snub requires a closed polyhedron");
+		return Topology(arena);
+	}
+	ArenaVector<std::array<float, 3>> centres(getFaceTotal(), std::array<float, 3>(), arena);
+	for(int f = 0; f < getFaceTotal(); f++) centres[f] = getFaceCentre(f);
+	ArenaVector<std::array<float, 3>> vs(getHalfEdgeTotal(), std::array<float, 3>(), arena);
+	std::vector<int> ring;
+	for(int v = 0; v < (int)vertices.size(); v++){ // centroid of the pentagon gyro gives the dual's half-edge into this one's face
+		getVertexRing(v, ring);
+		std::array<float, 3> mean = {0, 0, 0};
+		for(int h : ring) addScaled(mean, centres[faceOf[h]], 1.f / ring.size());
+		for(int h : ring){
+			addScaled(vs[h], mean, .2f);
+			addScaled(vs[h], centres[faceOf[twins[h]]], .2f);
+			addScaled(vs[h], centres[faceOf[h]], 8.f / 15.f);
+			addScaled(vs[h], centres[faceOf[rotate(h)]], 1.f / 15.f);
+		}
+	}
+	ArenaVector<int> offsets(arena), indices(arena);
+	offsets.reserve(getFaceTotal() + getHalfEdgeTotal() + vertices.size() + 1);
+	indices.reserve(getHalfEdgeTotal() * 5);
+	offsets.push_back(0);
+	for(int f = 0; f < getFaceTotal(); f++){
+		for(int h = faceOffsets[f]; h < faceOffsets[f + 1]; h++) indices.push_back(h);
+		offsets.push_back(indices.size());
+	}
+	for(int h = 0; h < getHalfEdgeTotal(); h++){
+		indices.insert(indices.end(), {h, next(twins[h]), rotate(next(h))});
+		offsets.push_back(indices.size());
+	}
+	for(int v = 0; v < (int)vertices.size(); v++){
+		getVertexRing(v, ring);
+		indices.insert(indices.end(), ring.begin(), ring.end());
+		offsets.push_back(indices.size());
+	}
+	return Topology(std::move(vs), std::move(offsets), std::move(indices), arena);
+}
+
+Topology Topology::meta() const { // face centres, vertex ring centres & edge centres, two triangles per old half-edge
+	if(!isClosed()){
+		debug("Error: meta requires a closed polyhedron");
+		return Topology(arena);
+	}
+	int const ringStart = getFaceTotal();
+	int const edgeStart = ringStart + vertices.size();
+	ArenaVector<std::array<float, 3>> vs(edgeStart + edgeTotal, std::array<float, 3>(), arena);
+	for(int f = 0; f < getFaceTotal(); f++) vs[f] = getFaceCentre(f);
+	std::vector<int> ring;
+	for(int v = 0; v < (int)vertices.size(); v++){ // mean of the edge midpoints around it, the centre of ambo's vertex face
+		getVertexRing(v, ring);
+		addScaled(vs[ringStart + v], vertices[v], .5f);
+		for(int h : ring) addScaled(vs[ringStart + v], vertices[target(h)], .5f / ring.size());
+	}
+	for(int h = 0; h < getHalfEdgeTotal(); h++){ // centre of the face & ring centres around the edge
+		if(twins[h] < h) continue;
+		std::array<float, 3> &centre = vs[edgeStart + edgeOf[h]];
+		for(int c : {faceOf[h], faceOf[twins[h]], ringStart + origins[h], ringStart + target(h)}) addScaled(centre, vs[c], .25f);
+	}
+	ArenaVector<int> offsets(arena), indices(arena);
+	offsets.reserve(getHalfEdgeTotal() * 2 + 1);
+	indices.reserve(getHalfEdgeTotal() * 6);
+	offsets.push_back(0);
+	for(int h = 0; h < getHalfEdgeTotal(); h++){
+		int const edge = edgeStart + edgeOf[h];
+		indices.insert(indices.end(), {faceOf[h], ringStart + origins[h], edge});
+		offsets.push_back(indices.size());
+		indices.insert(indices.end(), {ringStart + target(h), faceOf[h], edge});
+		offsets.push_back(indices.size());
+	}
+	return Topology(std::move(vs), std::move(offsets), std::move(indices), arena);
+}
+
+Topology Topology::bevel() const { // two vertices per half-edge, one at each end, a face per old face, vertex & edge
+	if(!isClosed()){
+		debug("Error: bevel requires a closed polyhedron");
+		return Topology(arena);
+	}
+	ArenaVector<std::array<float, 3>> centres(getFaceTotal(), std::array<float, 3>(), arena);
+	for(int f = 0; f < getFaceTotal(); f++) centres[f] = getFaceCentre(f);
+	ArenaVector<std::array<float, 3>> rings(vertices.size(), std::array<float, 3>(), arena);
+	std::vector<int> ring;
+	for(int v = 0; v < (int)vertices.size(); v++){
+		getVertexRing(v, ring);
+		addScaled(rings[v], vertices[v], .5f);
+		for(int h : ring) addScaled(rings[v], vertices[target(h)], .5f / ring.size());
+	}
+	ArenaVector<std::array<float, 3>> vs(getHalfEdgeTotal() * 2, std::array<float, 3>(), arena);
+	for(int h = 0; h < getHalfEdgeTotal(); h++){ // truncated ambo: the mean of the face, vertex ring & edge centres meeting at each end
+		std::array<float, 3> edge = {0, 0, 0};
+		for(std::array<float, 3> const &c : {centres[faceOf[h]], centres[faceOf[twins[h]]], rings[origins[h]], rings[target(h)]}) addScaled(edge, c, .25f);
+		for(int end = 0; end < 2; end++){
+			addScaled(vs[2 * h + end], centres[faceOf[h]], 1.f / 3.f);
+			addScaled(vs[2 * h + end], rings[end == 0 ? origins[h] : target(h)], 1.f / 3.f);
+			addScaled(vs[2 * h + end], edge, 1.f / 3.f);
+		}
+	}
+	ArenaVector<int> offsets(arena), indices(arena);
+	offsets.reserve(getFaceTotal() + vertices.size() + edgeTotal + 1);
+	indices.reserve(getHalfEdgeTotal() * 6);
+	offsets.push_back(0);
+	for(int f = 0; f < getFaceTotal(); f++){
+		for(int h = faceOffsets[f]; h < faceOffsets[f + 1]; h++) indices.insert(indices.end(), {2 * h, 2 * h + 1});
+		offsets.push_back(indices.size());
+	}
+	for(int v = 0; v < (int)vertices.size(); v++){
+		getVertexRing(v, ring);
+		for(int h : ring) indices.insert(indices.end(), {2 * h, 2 * prev(h) + 1});
+		offsets.push_back(indices.size());
+	}
+	for(int h = 0; h < getHalfEdgeTotal(); h++){
+		if(twins[h] < h) continue;
+		indices.insert(indices.end(), {2 * h + 1, 2 * h, 2 * twins[h] + 1, 2 * twins[h]});
+		offsets.push_back(indices.size());
+	}
+	return Topology(std::move(vs), std::move(offsets), std::move(indices), arena);
+}
+
+bool Topology::mutate(char op){
+	switch(op){
+		case 'd': *this = dual(); return true;
+		case 'a': *this = ambo(); return true;
+		case 'k': *this = kis(); return true;
+		case 'g': *this = gyro(); return true;
+		case 't': *this = truncate(); return true;
+		case 'e': *this = expand(); return true;
+		case 's': *this = snub(); return true;
+		case 'm': *this = meta(); return true;
+		case 'b': *this = bevel(); return true;
+		default: return false;
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef HEADER_TOPOLOGY
+#define HEADER_TOPOLOGY
+
+#include "../source/polyhedra.hpp" // polyhedron conversion
+#include "arena.hpp" // intermediate storage
+
+#include <vector> // flat storage
+#include <array> // vertex positions
+
+// flat half-edge representation: faces are CSR ranges of half-edges, each half-edge storing its origin vertex
+// given an arena, every array of this and each operator's result is taken from it, and freed only when the arena is
+struct Topology{
+
+	// storage
+	Arena *arena;
+
+	// geometry
+	ArenaVector<std::array<float, 3>> vertices;
+
+	// faces
+	ArenaVector<int> faceOffsets; // face f owns half-edges [faceOffsets[f], faceOffsets[f + 1])
+	ArenaVector<int> origins; // half-edge origin vertex, i.e. the CSR face indices
+
+	// adjacency
+	ArenaVector<int> faceOf; // half-edge face
+	ArenaVector<int> twins; // opposite half-edge, -1 on open boundaries
+	ArenaVector<int> edgeOf; // half-edge undirected edge index
+	ArenaVector<int> vertexEdges; // one outgoing half-edge per vertex
+	int edgeTotal;
+
+	// construction
+	Topology(Arena *a = nullptr);
+	Topology(Polyhedron const &p, Arena *a = nullptr);
+	Topology(ArenaVector<std::array<float, 3>> &&vs, ArenaVector<int> &&offsets, ArenaVector<int> &&indices, Arena *a);
+	void link(); // builds adjacency from vertices, faceOffsets & origins
+	void toPolyhedron(Polyhedron &p) const;
+
+	// queries
+	int getFaceTotal() const { return (int)faceOffsets.size() - 1; }
+	int getHalfEdgeTotal() const { return (int)origins.size(); }
+	int getFaceSize(int f) const { return faceOffsets[f + 1] - faceOffsets[f]; }
+	int next(int h) const { return h + 1 == faceOffsets[faceOf[h] + 1] ? faceOffsets[faceOf[h]] : h + 1; }
+	int prev(int h) const { return h == faceOffsets[faceOf[h]] ? faceOffsets[faceOf[h] + 1] - 1 : h - 1; }
+	int target(int h) const { return origins[next(h)]; }
+	int rotate(int h) const { return twins[prev(h)]; } // next outgoing half-edge anticlockwise around origins[h]
+	bool isClosed() const;
+	std::array<float, 3> getFaceCentre(int f) const;
+	void getVertexRing(int v, std::vector<int> &outgoing) const; // anticlockwise outgoing half-edges
+
+	// operators
+	Topology dual() const;
+	Topology ambo() const;
+	Topology kis() const;
+	Topology gyro() const;
+
+	// compound operators, built straight from this polyhedron with the graph & vertex positions of their d a k g chains
+	Topology truncate() const; // dkd
+	Topology expand() const; // aa
+	Topology snub() const; // dgd
+	Topology meta() const; // kda
+	Topology bevel() const; // dkda
+	bool mutate(char op); // d a k g t e s m b, in place
+};
+
+#endif
@@ -0,0 +1,182 @@
+#include "triangulator.hpp"
+
+#include <cmath> // normal & score powers
+#include <algorithm> // index searching
+
+namespace{
+	float cross(std::array<float, 2> const &a, std::array<float, 2> const &b, std::array<float, 2> const &c){
+		return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+	}
+	bool isInside(std::array<float, 2> const &p, std::array<float, 2> const &a, std::array<float, 2> const &b, std::array<float, 2> const &c){ // anticlockwise a b c, boundary excluded
+		return cross(a, b, p) > 0 && cross(b, c, p) > 0 && cross(c, a, p) > 0;
+	}
+	float getVertexScore(int cachePosition, int activeTriangles){ // Forsyth's weights
+		if(activeTriangles == 0) return -1.f;
+		float score = 0;
+		if(cachePosition >= 3) score = std::pow(1.f - (cachePosition - 3) * (1.f / (TRIANGULATOR_CACHE_SIZE - 3)), 1.5f);
+		else if(cachePosition >= 0) score = .75f; // the last triangle's vertices, equally
+		return score + 2.f * std::pow((float)activeTriangles, -.5f);
+	}
+}
+
+// triangulation
+
+bool Triangulator::triangulateFace(std::vector<std::array<float, 3>> const &vertices, std::vector<int> const &face, std::vector<std::array<int, 3>> &corners){
+	int const n = face.size();
+	if(n < 3) return true;
+	if(n == 3){
+		corners.push_back({0, 1, 2});
+		return true;
+	}
+
+	// projection onto the plane's two least-normal axes, winding anticlockwise
+	std::array<float, 3> normal = {0, 0, 0};
+	for(int f = 0; f < n; f++){
+		std::array<float, 3> const &a = vertices[face[f]];
+		std::array<float, 3> const &b = vertices[face[(f + 1) % n]];
+		normal[0] += (a[1] - b[1]) * (a[2] + b[2]);
+		normal[1] += (a[2] - b[2]) * (a[0] + b[0]);
+		normal[2] += (a[0] - b[0]) * (a[1] + b[1]);
+	}
+	int axis = 0;
+	for(int i = 1; i < 3; i++) if(std::fabs(normal[i]) > std::fabs(normal[axis])) axis = i;
+	float const flip = normal[axis] < 0 ? -1.f : 1.f;
+	std::vector<std::array<float, 2>> points(n);
+	for(int f = 0; f < n; f++) points[f] = {vertices[face[f]][(axis + 1) % 3], vertices[face[f]][(axis + 2) % 3] * flip};
+
+	// ears
+	std::vector<int> remaining(n);
+	for(int f = 0; f < n; f++) remaining[f] = f;
+	bool isClean = true;
+	while(remaining.size() > 3){
+		int const m = remaining.size();
+		int ear = -1, sharpest = 0;
+		float sharpestCross = -INFINITY;
+		for(int r = 0; r < m && ear == -1; r++){
+			int const a = remaining[(r + m - 1) % m], b = remaining[r], c = remaining[(r + 1) % m];
+			float const turn = cross(points[a], points[b], points[c]);
+			if(turn > sharpestCross){
+				sharpestCross = turn;
+				sharpest = r;
+			}
+			if(turn <= 0) continue; // reflex or flat corner
+			bool isEmpty = true;
+			for(int o = 0; o < m && isEmpty; o++){
+				int const p = remaining[o];
+				if(p != a && p != b && p != c && isInside(points[p], points[a], points[b], points[c])) isEmpty = false;
+			}
+			if(isEmpty) ear = r;
+		}
+		if(ear == -1){ // self-intersecting or degenerate; clip the most convex corner to still give n - 2 triangles
+			isClean = false;
+			ear = sharpest;
+		}
+		corners.push_back({remaining[(ear + m - 1) % m], remaining[ear], remaining[(ear + 1) % m]});
+		remaining.erase(remaining.begin() + ear);
+	}
+	corners.push_back({remaining[0], remaining[1], remaining[2]});
+	return isClean;
+}
+
+void Triangulator::triangulate(std::vector<std::array<float, 3>> const &vertices, std::vector<std::vector<int>> const &faces, std::vector<int> &indices){
+	int triangleTotal = 0;
+	for(std::vector<int> const &face : faces) if(face.size() > 2) triangleTotal += face.size() - 2;
+	indices.reserve(indices.size() + triangleTotal * 3);
+	std::vector<std::array<int, 3>> corners;
+	for(std::vector<int> const &face : faces){
+		corners.clear();
+		triangulateFace(vertices, face, corners);
+		for(std::array<int, 3> const &corner : corners)
+			for(int c : corner) indices.push_back(face[c]);
+	}
+}
+
+// reordering
+
+void Triangulator::optimise(std::vector<int> &indices, int vertexTotal){
+	int const triangleTotal = indices.size() / 3;
+	if(triangleTotal < 2) return;
+
+	// triangles per vertex, the first active[v] of each range not yet emitted
+	std::vector<int> offsets(vertexTotal + 1, 0);
+	for(int i : indices) offsets[i + 1]++;
+	for(int v = 0; v < vertexTotal; v++) offsets[v + 1] += offsets[v];
+	std::vector<int> vertexTriangles(indices.size());
+	std::vector<int> active(vertexTotal, 0);
+	for(int i = 0; i < (int)indices.size(); i++){
+		int const v = indices[i];
+		vertexTriangles[offsets[v] + active[v]++] = i / 3;
+	}
+
+	// scores
+	std::vector<int> cachePositions(vertexTotal, -1);
+	std::vector<float> vertexScores(vertexTotal);
+	for(int v = 0; v < vertexTotal; v++) vertexScores[v] = getVertexScore(-1, active[v]);
+	std::vector<float> triangleScores(triangleTotal);
+	int best = 0;
+	for(int t = 0; t < triangleTotal; t++){
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+		if(triangleScores[t] > triangleScores[best]) best = t;
+	}
+
+	// greedy emission
+	std::vector<char> isEmitted(triangleTotal, 0);
+	std::vector<int> output, cache, next;
+	output.reserve(indices.size());
+	cache.reserve(TRIANGULATOR_CACHE_SIZE + 3);
+	next.reserve(TRIANGULATOR_CACHE_SIZE + 3);
+	int cursor = 0;
+	for(int emitted = 0; emitted < triangleTotal; emitted++){
+		if(best == -1){ // nothing left around the cache; resume in input order
+			while(isEmitted[cursor]) cursor++;
+			best = cursor;
+		}
+		isEmitted[best] = 1;
+		next.clear();
+		for(int k = 0; k < 3; k++){
+			int const v = indices[best * 3 + k];
+			output.push_back(v);
+			int *const list = &vertexTriangles[offsets[v]];
+			int *const found = std::find(list, list + active[v], best);
+			if(found != list + active[v]) std::swap(*found, list[--active[v]]);
+			if(std::find(next.begin(), next.end(), v) == next.end()) next.push_back(v);
+		}
+		for(int v : cache) if(std::find(next.begin(), next.end(), v) == next.end()) next.push_back(v);
+
+		// rescoring around the cache, including vertices just pushed out of it
+		for(int c = 0; c < (int)next.size(); c++){
+			int const v = next[c];
+			cachePositions[v] = c < TRIANGULATOR_CACHE_SIZE ? c : -1;
+			vertexScores[v] = getVertexScore(cachePositions[v], active[v]);
+		}
+		best = -1;
+		float bestScore = -INFINITY;
+		for(int v : next){
+			for(int a = 0; a < active[v]; a++){
+				int const t = vertexTriangles[offsets[v] + a];
+				triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+				if(triangleScores[t] > bestScore){
+					bestScore = triangleScores[t];
+					best = t;
+				}
+			}
+		}
+		if((int)next.size() > TRIANGULATOR_CACHE_SIZE) next.resize(TRIANGULATOR_CACHE_SIZE);
+		cache.swap(next);
+	}
+	indices.swap(output);
+}
+
+float Triangulator::getACMR(std::vector<int> const &indices, int cacheSize){
+	if(indices.size() < 3) return 0;
+	int vertexTotal = 0;
+	for(int i : indices) vertexTotal = std::max(vertexTotal, i + 1);
+	std::vector<long long> enteredAt(vertexTotal, -(long long)cacheSize - 1); // miss count when each vertex entered the FIFO
+	long long misses = 0;
+	for(int i : indices){
+		if(misses - enteredAt[i] < cacheSize) continue;
+		misses++;
+		enteredAt[i] = misses;
+	}
+	return (float)misses / (indices.size() / 3);
+}
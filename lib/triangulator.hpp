@@ -0,0 +1,23 @@
+#ifndef HEADER_TRIANGULATOR
+#define HEADER_TRIANGULATOR
+
+#include <vector> // index lists
+#include <array> // positions & triangles
+
+#define TRIANGULATOR_CACHE_SIZE 32 // modelled LRU cache for reordering
+#define TRIANGULATOR_ACMR_CACHE_SIZE 16 // modelled FIFO cache for reporting
+
+struct Triangulator{
+	// ear clipping in the face's plane; corners are positions within the face, wound as the face is, n - 2 per face
+	// returns false when no clean ear was found and a remaining corner was clipped regardless
+	static bool triangulateFace(std::vector<std::array<float, 3>> const &vertices, std::vector<int> const &face, std::vector<std::array<int, 3>> &corners);
+	static void triangulate(std::vector<std::array<float, 3>> const &vertices, std::vector<std::vector<int>> const &faces, std::vector<int> &indices);
+
+	// Forsyth's linear-speed reordering of triangles for post-transform vertex cache locality
+	static void optimise(std::vector<int> &indices, int vertexTotal);
+
+	// average cache miss ratio: transformed vertices per triangle, between 0.5 for ideal meshes and 3
+	static float getACMR(std::vector<int> const &indices, int cacheSize = TRIANGULATOR_ACMR_CACHE_SIZE);
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "upload.hpp"
+#include "triangulator.hpp"
+#include "../utils/debug.hpp"
+
+#include <cstring> // section packing
+#include <algorithm> // chunk sizing
+
+namespace{
+	template <typename T>
+	std::size_t append(std::vector<char> &bytes, std::vector<T> const &data){
+		std::size_t const offset = bytes.size();
+		bytes.resize(offset + data.size() * sizeof(T));
+		if(!data.empty()) memcpy(&bytes[offset], data.data(), data.size() * sizeof(T));
+		return bytes.size();
+	}
+}
+
+// pipeline methods
+
+UploadPipeline::UploadPipeline(bool quantised, std::size_t bytesPerFrame) :
+	isBuilding(false), isStopping(false), isQuantised(quantised), generation(0), stage(0), reused(-1), written(0), frameBytes(bytesPerFrame > 0 ? bytesPerFrame : UPLOAD_FRAME_BYTES) {
+	for(std::unique_ptr<Buffer> &buffer : stages) buffer.reset(new Buffer(BufferStream, NULL, 0));
+	builder = std::thread(&UploadPipeline::buildLoop, this);
+}
+
+UploadPipeline::~UploadPipeline(){
+	{
+	std::lock_guard<std::mutex> guard(lock);
+	isStopping = true;
+	}
+	wake.notify_all();
+	builder.join();
+}
+
+void UploadPipeline::submit(std::shared_ptr<Mesh> mesh){
+	for(int s = 0; s < 2; s++){
+		if(!stagedPayloads[s] || stagedMeshes[s].lock() != mesh) continue;
+		{
+		std::lock_guard<std::mutex> guard(lock);
+		requested.reset();
+		built.reset();
+		generation++;
+		}
+		staging.reset();
+		reused = s;
+		return;
+	}
+	{
+	std::lock_guard<std::mutex> guard(lock);
+	requested = std::move(mesh);
+	}
+	reused = -1;
+	wake.notify_all();
+}
+
+bool UploadPipeline::isBusy(){
+	std::lock_guard<std::mutex> guard(lock);
+	return requested || built || isBuilding || staging || reused != -1;
+}
+
+void UploadPipeline::buildLoop(){
+	std::unique_lock<std::mutex> guard(lock);
+	while(true){
+		wake.wait(guard, [this](){ return isStopping || requested; });
+		if(isStopping) return;
+		std::shared_ptr<Mesh> mesh = std::move(requested);
+		std::size_t const jobGeneration = generation;
+		isBuilding = true;
+		guard.unlock();
+		std::unique_ptr<UploadPayload> payload(new UploadPayload());
+		pack(*mesh, *payload, isQuantised);
+		guard.lock();
+		if(generation == jobGeneration){
+			built = std::move(payload);
+			builtMesh = mesh;
+		}
+		isBuilding = false;
+	}
+}
+
+void UploadPipeline::pack(Mesh &mesh, UploadPayload &payload, bool isQuantised){
+	std::size_t const vertexTotal = mesh.getIndexVertices().size(); // serial float positions are built only for float uploads
+	std::vector<int> const &triangles = mesh.getTriangularFaces();
+	std::vector<int> const &lines = mesh.getSerialEdges();
+	std::vector<MeshVertex> const &interleaved = mesh.getInterleavedVertices();
+	payload.bytes.clear();
+	payload.offsets[UploadVertices] = 0;
+	payload.scale = 1;
+	payload.indexType = IndexUint;
+	if(isQuantised){
+		bool const isShort = mesh.hasShortIndices();
+		payload.bytes.reserve(sizeof(std::int16_t) * 4 * vertexTotal + (isShort ? sizeof(std::uint16_t) : sizeof(int)) * (triangles.size() + lines.size()) +
+			sizeof(MeshPackedVertex) * interleaved.size());
+		payload.offsets[UploadTriangles] = append(payload.bytes, mesh.getPackedVertices());
+		payload.offsets[UploadLines] = isShort ? append(payload.bytes, mesh.getShortTriangularFaces()) : append(payload.bytes, triangles);
+		payload.offsets[UploadInterleaved] = isShort ? append(payload.bytes, mesh.getShortSerialEdges()) : append(payload.bytes, lines);
+		payload.offsets[UploadSectionTotal] = append(payload.bytes, mesh.getPackedInterleavedVertices());
+		payload.scale = mesh.getPackedScale();
+		if(isShort) payload.indexType = IndexUshort;
+	}
+	else{
+		payload.bytes.reserve(sizeof(float) * 3 * vertexTotal + sizeof(int) * (triangles.size() + lines.size()) + sizeof(MeshVertex) * interleaved.size());
+		payload.offsets[UploadTriangles] = append(payload.bytes, mesh.getSerialVertices());
+		payload.offsets[UploadLines] = append(payload.bytes, triangles);
+		payload.offsets[UploadInterleaved] = append(payload.bytes, lines);
+		payload.offsets[UploadSectionTotal] = append(payload.bytes, interleaved);
+	}
+	payload.pointTotal = vertexTotal;
+	payload.triangleTotal = triangles.size();
+	payload.lineTotal = lines.size();
+	payload.interleavedTotal = interleaved.size();
+	payload.triangleACMR = Triangulator::getACMR(triangles);
+	payload.clusters = mesh.getClusters();
+}
+
+UploadPayload const *UploadPipeline::step(std::array<Buffer*, UploadSectionTotal> const &targets){
+
+	// a resubmitted mesh still whole in a staging buffer, copied again this frame
+	if(reused != -1){
+		for(int s = 0; s < UploadSectionTotal; s++){
+			std::size_t const size = stagedPayloads[reused]->getSectionBytes((UploadSection)s);
+			targets[s]->reserve(size);
+			if(size > 0) targets[s]->copy(*stages[reused], stagedPayloads[reused]->offsets[s], size, 0);
+		}
+		stage = reused; // the next payload overwrites the other stage
+		reused = -1;
+		completed = stagedPayloads[stage];
+		return completed.get();
+	}
+
+	// take the newest built payload once the last one is current
+	if(!staging){
+		{
+		std::lock_guard<std::mutex> guard(lock);
+		staging = std::move(built);
+		stagingMesh = builtMesh;
+		}
+		if(!staging) return nullptr;
+		stage = 1 - stage;
+		stagedPayloads[stage].reset();
+		stagedMeshes[stage].reset();
+		stages[stage]->reserve(staging->bytes.size());
+		written = 0;
+	}
+
+	// write this frame's share into staging
+	std::size_t const chunk = std::min(frameBytes, staging->bytes.size() - written);
+	if(chunk > 0) stages[stage]->update(&staging->bytes[written], chunk, written);
+	written += chunk;
+	if(written < staging->bytes.size()) return nullptr;
+
+	// whole payload staged, copied into the drawn buffers at once
+	for(int s = 0; s < UploadSectionTotal; s++){
+		std::size_t const size = staging->getSectionBytes((UploadSection)s);
+		targets[s]->reserve(size);
+		if(size > 0) targets[s]->copy(*stages[stage], staging->offsets[s], size, 0);
+	}
+	staging->bytes = std::vector<char>(); // kept on the GPU in the stage from here
+	stagedPayloads[stage] = staging;
+	stagedMeshes[stage] = stagingMesh;
+	completed = std::move(staging);
+	return completed.get();
+}
@@ -0,0 +1,76 @@
+#ifndef HEADER_UPLOAD
+#define HEADER_UPLOAD
+
+#include "shader.hpp" // GPU buffers
+#include "model.hpp" // derived mesh data
+
+#include <vector> // packed payloads
+#include <array> // section offsets & targets
+#include <memory> // payload handover
+#include <thread> // off-thread building
+#include <mutex> // handover locking
+#include <condition_variable> // build signalling
+#include <cstddef> // byte sizes
+
+#define UPLOAD_FRAME_BYTES (2 << 20) // staging bytes written per displayed frame
+
+enum UploadSection{
+	UploadVertices, // serial vertices
+	UploadTriangles, // triangle indices
+	UploadLines, // line indices
+	UploadInterleaved, // interleaved triangle vertices
+	UploadSectionTotal
+};
+
+struct UploadPayload{ // a mesh's derived GPU data, packed section after section
+	std::vector<char> bytes;
+	std::array<std::size_t, UploadSectionTotal + 1> offsets; // section s spans [offsets[s], offsets[s + 1])
+	std::size_t pointTotal, triangleTotal, lineTotal, interleavedTotal; // draw counts
+	float triangleACMR; // modelled vertex cache misses per triangle
+	float scale; // model positions per unit of the uploaded positions
+	IndexType indexType; // of the triangle & line sections
+	std::vector<MeshCluster> clusters; // culling bounds over the triangle sections
+	std::size_t getSectionBytes(UploadSection s) const { return offsets[s + 1] - offsets[s]; }
+	char const *getSectionData(UploadSection s) const { return bytes.data() + offsets[s]; }
+};
+
+// meshes are built & packed on a worker thread, written into one of two staging buffers over several frames,
+// then copied on the GPU into the drawn buffers in a single frame, so the previous mesh is drawn until the new one is whole;
+// each staging buffer keeps the last mesh written into it, so resubmitting that mesh (e.g. switching back to a detail level)
+// is copied again at once, without building or staging anything
+class UploadPipeline{
+
+	// building
+	std::thread builder;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::shared_ptr<Mesh> requested; // newest submitted mesh, superseding any not yet started
+	std::unique_ptr<UploadPayload> built; // newest packed payload, superseding any not yet staged
+	std::weak_ptr<Mesh const> builtMesh; // the mesh built was packed from
+	std::size_t generation; // bumped when a staged mesh is reused, so builds it superseded are dropped
+	bool isBuilding, isStopping;
+	bool isQuantised; // Mesh's packed vertex & index formats in place of floats & ints
+	void buildLoop();
+
+	// staging
+	std::array<std::unique_ptr<Buffer>, 2> stages; // alternated per payload, so writing one never waits on copies from the other
+	std::array<std::shared_ptr<UploadPayload>, 2> stagedPayloads; // counts & sections of each stage's whole payload, bytes released
+	std::array<std::weak_ptr<Mesh const>, 2> stagedMeshes; // the meshes they were packed from
+	int stage, reused; // stage written last, & stage to copy from again on the next step or -1
+	std::shared_ptr<UploadPayload> staging, completed;
+	std::weak_ptr<Mesh const> stagingMesh;
+	std::size_t written, frameBytes;
+
+	// usage
+public:
+	UploadPipeline(bool quantised = false, std::size_t bytesPerFrame = UPLOAD_FRAME_BYTES); // needs a current GL context
+	~UploadPipeline();
+	UploadPipeline(UploadPipeline const &) = delete;
+	UploadPipeline &operator=(UploadPipeline const &) = delete;
+	void submit(std::shared_ptr<Mesh> mesh); // returns immediately; derived data is built into the shared mesh, whose index data must stay unchanged
+	bool isBusy(); // a mesh is being built, staged or copied
+	UploadPayload const *step(std::array<Buffer*, UploadSectionTotal> const &targets); // once per frame; the payload made current this frame, if any
+	static void pack(Mesh &mesh, UploadPayload &payload, bool isQuantised = false);
+};
+
+#endif
@@ -1,6 +1,9 @@
 #include "window.hpp"
 #include "../utils/debug.hpp"
 
+#include <thread> // rate waiting
+#include <algorithm> // earliest rate
+
 // internal methods
 
 namespace{
@@ -56,10 +59,10 @@ Window::Window(const char *name, Uint32 flags, int w, int h, float frameRate, fl
 	}
 	
 	// time
-	timeStart = 0;
-	timePrev[0] = timePrev[1] = 0;
-	timePeriod[0] = CLOCKS_PER_SEC * (1.f / frameRate);
-	timePeriod[1] = CLOCKS_PER_SEC * (1.f / inputRate);
+	timeStart = std::chrono::steady_clock::now();
+	timePrev[0] = timePrev[1] = timeStart;
+	timePeriod[0] = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.f / frameRate));
+	timePeriod[1] = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.f / inputRate));
 	
 	// input
 	for(int i = 0; i < WINDOW_KEYCODES; i++) keyMap[i] = 0;
@@ -81,18 +84,24 @@ Window::~Window(){
 }
 
 void Window::timer(){
-	timeStart = clock();
+	timeStart = std::chrono::steady_clock::now();
 	for(int i = 0; i < WINDOW_RATES; i++) timePrev[i] = timeStart - timePeriod[i];
 }
 
 // update methods
 
 bool Window::cap(WindowRate type){
-	if(clock() - timePrev[type] > timePeriod[type]){
-		timePrev[type] += timePeriod[type];
-		return true;
-	}
-	return false;
+	std::chrono::steady_clock::time_point const now = std::chrono::steady_clock::now();
+	if(now - timePrev[type] < timePeriod[type]) return false;
+	timePrev[type] += timePeriod[type];
+	if(now - timePrev[type] > timePeriod[type] * WINDOW_MAX_LAG) timePrev[type] = now; // after a stall, resume pacing instead of catching up in a burst
+	return true;
+}
+
+void Window::wait() const {
+	std::chrono::steady_clock::time_point due = timePrev[0] + timePeriod[0];
+	for(int i = 1; i < WINDOW_RATES; i++) due = std::min(due, timePrev[i] + timePeriod[i]);
+	std::this_thread::sleep_until(due);
 }
 
 WindowState Window::get(){
@@ -185,6 +194,10 @@ void Window::unfocus(){
 	isWindowFocused = false;
 }
 
+void Window::title(std::string const &text){
+	SDL_SetWindowTitle(window, text.c_str());
+}
+
 // properties
 
 float Window::getAspectRatio() const {
@@ -11,7 +11,8 @@
 #include "SDL2/SDL_opengl.h" // OpenGL options
 
 #include <map> // input binding
-#include <ctime> // update rate
+#include <chrono> // update rate
+#include <string> // window titles
 #include <vector> // multiple bindings
 
 #define WINDOW_KEYCODES (128 + 226)
@@ -22,6 +23,7 @@
 #define INPUT_SENS_SCROLL 0.05f
 
 #define WINDOW_RATES 2
+#define WINDOW_MAX_LAG 4 // periods a rate may fall behind before the missed ones are dropped
 
 enum WindowFlag{
 	WindowResize = SDL_WINDOW_RESIZABLE, 
@@ -85,10 +87,10 @@ class Window{
 	SDL_Window *window;
 	SDL_GLContext context;
 	
-	// time
-	clock_t timeStart;
-	clock_t timePeriod[WINDOW_RATES]; // frame, input
-	clock_t timePrev[WINDOW_RATES];
+	// time, by wall clock so pacing holds under load
+	std::chrono::steady_clock::time_point timeStart;
+	std::chrono::steady_clock::duration timePeriod[WINDOW_RATES]; // frame, input
+	std::chrono::steady_clock::time_point timePrev[WINDOW_RATES];
 	
 	// focus
 	bool isWindowFocused;
@@ -109,11 +111,13 @@ public:
 	
 	// update
 	bool cap(WindowRate type);
+	void wait() const; // sleeps until the next rate is due
 	WindowState get();
 	void clear() const;
 	void swap() const;
 	void focus();
 	void unfocus();
+	void title(std::string const &text);
 	
 	// properties
 	float getAspectRatio() const;
@@ -0,0 +1,120 @@
+#include "workpool.hpp"
+#include "../utils/usage.hpp"
+
+// worker usage
+
+float WorkerUsage::getUtilisation() const {
+	return wallSeconds > 0 ? busySeconds / wallSeconds : 0.f;
+}
+
+// pool methods
+
+WorkPool::WorkPool(std::size_t threadTotal) : task(nullptr), generation(0), active(0), isStopping(false) {
+	if(threadTotal == 0) threadTotal = std::thread::hardware_concurrency();
+	if(threadTotal == 0) threadTotal = 1;
+	for(std::size_t w = 0; w < threadTotal; w++) workers.push_back(std::make_unique<Worker>());
+	threads.reserve(threadTotal - 1);
+	for(std::size_t w = 1; w < threadTotal; w++) threads.emplace_back(&WorkPool::loop, this, w);
+}
+
+WorkPool::~WorkPool(){
+	{
+	std::lock_guard<std::mutex> guard(runLock);
+	isStopping = true;
+	}
+	wake.notify_all();
+	for(std::thread &thread : threads) thread.join();
+}
+
+void WorkPool::run(std::size_t jobs, std::function<void(std::size_t)> const &runTask){
+
+	// distribute round-robin, so neighbouring streams of similar cost spread across workers
+	for(std::unique_ptr<Worker> &worker : workers){
+		worker->jobs.clear();
+		worker->usage = WorkerUsage{0, 0, 0., 0.};
+	}
+	for(std::size_t j = 0; j < jobs; j++) workers[j % workers.size()]->jobs.push_back(j);
+
+	// execute
+	Stopwatch wall;
+	{
+	std::lock_guard<std::mutex> guard(runLock);
+	task = &runTask;
+	active = threads.size();
+	generation++;
+	}
+	wake.notify_all();
+	work(0, runTask);
+	{
+	std::unique_lock<std::mutex> guard(runLock);
+	done.wait(guard, [this]{ return active == 0; });
+	task = nullptr;
+	}
+	double const seconds = wall.getSeconds();
+	for(std::unique_ptr<Worker> &worker : workers) worker->usage.wallSeconds = seconds;
+}
+
+std::size_t WorkPool::getThreads() const {
+	return workers.size();
+}
+
+WorkerUsage const &WorkPool::getUsage(std::size_t w) const {
+	return workers[w]->usage;
+}
+
+// scheduling
+
+void WorkPool::loop(std::size_t w){
+	std::size_t seen = 0;
+	while(true){
+		std::function<void(std::size_t)> const *current;
+		{
+		std::unique_lock<std::mutex> guard(runLock);
+		wake.wait(guard, [this, seen]{ return isStopping || generation != seen; });
+		if(isStopping) return;
+		seen = generation;
+		current = task;
+		}
+		work(w, *current);
+		{
+		std::lock_guard<std::mutex> guard(runLock);
+		if(--active == 0) done.notify_one();
+		}
+	}
+}
+
+bool WorkPool::pop(std::size_t w, std::size_t &job){ // own queue, oldest first
+	Worker &worker = *workers[w];
+	std::lock_guard<std::mutex> guard(worker.lock);
+	if(worker.jobs.empty()) return false;
+	job = worker.jobs.front();
+	worker.jobs.pop_front();
+	return true;
+}
+
+bool WorkPool::steal(std::size_t w, std::size_t &job){ // other queues, newest first
+	for(std::size_t offset = 1; offset < workers.size(); offset++){
+		Worker &victim = *workers[(w + offset) % workers.size()];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if(victim.jobs.empty()) continue;
+		job = victim.jobs.back();
+		victim.jobs.pop_back();
+		return true;
+	}
+	return false;
+}
+
+void WorkPool::work(std::size_t w, std::function<void(std::size_t)> const &task){
+	WorkerUsage &usage = workers[w]->usage;
+	std::size_t job;
+	while(true){
+		if(!pop(w, job)){
+			if(!steal(w, job)) break; // no jobs are queued during a run, so empty queues are final
+			usage.steals++;
+		}
+		Stopwatch busy;
+		task(job);
+		usage.busySeconds += busy.getSeconds();
+		usage.jobs++;
+	}
+}
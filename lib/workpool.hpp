@@ -0,0 +1,55 @@
+#ifndef HEADER_WORKPOOL
+#define HEADER_WORKPOOL
+
+#include <vector> // worker storage
+#include <deque> // job queues
+#include <mutex> // queue locking
+#include <condition_variable> // run signalling
+#include <thread> // persistent workers
+#include <memory> // worker allocation
+#include <functional> // job tasks
+#include <cstddef> // job indices
+
+struct WorkerUsage{
+	std::size_t jobs; // jobs completed
+	std::size_t steals; // jobs taken from other workers
+	double busySeconds; // time spent inside tasks
+	double wallSeconds; // time from start to finish of the run
+	float getUtilisation() const;
+};
+
+class WorkPool{
+
+	// workers
+	struct Worker{
+		std::mutex lock;
+		std::deque<std::size_t> jobs;
+		WorkerUsage usage;
+	};
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads; // workers 1 onwards; the calling thread is worker 0
+
+	// signalling
+	std::mutex runLock;
+	std::condition_variable wake, done;
+	std::function<void(std::size_t)> const *task;
+	std::size_t generation; // incremented per run, so each thread joins every run once
+	std::size_t active; // helper threads still working on the current run
+	bool isStopping;
+	void loop(std::size_t w);
+
+	// scheduling
+	bool pop(std::size_t w, std::size_t &job);
+	bool steal(std::size_t w, std::size_t &job);
+	void work(std::size_t w, std::function<void(std::size_t)> const &task);
+
+	// usage
+public:
+	WorkPool(std::size_t threads); // 0 selects the hardware thread count
+	~WorkPool();
+	void run(std::size_t jobs, std::function<void(std::size_t)> const &task); // blocks until every job index has run; not reentrant from tasks
+	std::size_t getThreads() const;
+	WorkerUsage const &getUsage(std::size_t w) const;
+};
+
+#endif
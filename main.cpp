@@ -4,6 +4,18 @@
 #include "source/polyhedra.hpp" // polyhedron generation
 #include "source/maths.hpp" // model rotation
 #include "lib/model.hpp" // polyhedron model representation
+#include "lib/operatorqueue.hpp" // background operators
+#include "lib/upload.hpp" // staged mesh uploads
+#include "lib/workpool.hpp" // parallel relaxation
+#include "lib/exporter.hpp" // mesh export
+#include "lib/polyfile.hpp" // baked polyhedron loading
+#include "lib/gallery.hpp" // catalogue sheets
+#include "lib/batch.hpp" // catalogue generation
+#include "lib/polycache.hpp" // shared suffix reuse
+#include "lib/streamplan.hpp" // startup generation
+#include "lib/profiler.hpp" // frame profiling
+#include "lib/culling.hpp" // cluster culling
+#include "lib/detail.hpp" // level of detail
 #include "utils/argument.hpp" // argument fetching
 #include "utils/debug.hpp" // debugging
 #include "utils/filemanager.hpp" // file fetching
@@ -11,7 +23,11 @@
 #include <vector> // mesh data
 #include <array> // data passing
 #include <list> // list renderers
-#include <stdio.h> // export mesh
+#include <cstddef> // interleaved attribute offsets
+#include <fstream> // gallery stream file input
+#include <string> // cluster reporting
+#include <algorithm> // export naming
+#include <memory> // shared meshes
 
 #define WINDOW_WIDTH 800
 #define WINDOW_HEIGHT 600
@@ -25,10 +41,19 @@
 #define PROJECTION_FAR 100.f
 
 #define MODEL_ROTATE_SENS .05f
-#define MODEL_MAX_VERTICES 10000
-#define MODEL_MAX_FACES 10000
-#define MODEL_MAX_LINES 10000
-#define MODEL_MAX_WHEEL_FACES 20000
+
+#define GALLERY_CACHE_MEGABYTES 256
+#define GALLERY_PLACEMENT_UNIT 0 // texture unit of the per-slot placement table
+
+#define PROFILE_SUMMARY_FRAMES 144 // frames averaged into the window title, about a second's worth
+
+#define TRANSFORM_BINDING 0 // uniform block binding point shared by every program
+
+// data
+struct TransformBlock{ // std140 layout of the shaders' Transforms block
+	std::array<float, 16> vp;
+	std::array<float, 16> m;
+};
 
 // indexing
 enum ProgramInput{
@@ -45,7 +70,12 @@ enum ProgramInput{
 enum ArgumentType{
 	ArgumentOperators, // operator stream
 	ArgumentRenderer, // model renderer id
-	ArgumentProjection // camera projection id
+	ArgumentProjection, // camera projection id
+	ArgumentFormat, // export format id
+	ArgumentLoad, // baked polyhedron file
+	ArgumentGallery, // catalogue stream file
+	ArgumentProfile, // frame profile file
+	ArgumentVertex // vertex format id
 };
 enum RendererType{
 	RendererPoint, 
@@ -54,35 +84,24 @@ enum RendererType{
 	RendererSolidwire
 };
 
-// export
-
-void exportData(const char *name, std::vector<float> vertices, std::vector<int> faces){ // assume triangular faces for import/export simplicity, instead of n-faces for data simplicity
-	std::string noCanonName = name;
-	noCanonName.erase(std::remove(noCanonName.begin(), noCanonName.end(), 'c'), noCanonName.end());
-	std::string fileName = noCanonName + ".obj";
-	FILE *fp = fopen(fileName.c_str(), "a");
-	if(fp == NULL){
-		debug("export failed", fileName);
-		return;
-	}
-	fprintf(fp, "o %s\n", noCanonName.c_str());
-	for(int i = 0; i < vertices.size(); i += 3) fprintf(fp, "v %.4f %.4f %.4f\n", vertices[i + 0], vertices[i + 1], vertices[i + 2]);
-	for(int i = 0; i < faces.size(); i += 3) fprintf(fp, "f %i %i %i\n", faces[i + 0] + 1, faces[i + 1] + 1, faces[i + 2] + 1);
-	fclose(fp);
-	debug("export success", fileName);
-}
-
-
 int main(int argc, char *argv[]){ 
 	
 	// arguments
 	std::string operators;
+	std::string loadName;
+	std::string galleryName;
+	std::string profileName;
 	RendererType rendererId;
 	ProjectionType projectionId;
+	ExportFormat formatId;
+	bool isPackedFormat;
 	{
-	std::vector<std::string> const properties = ArgumentReader::get(argc - 1, &argv[1], {"--operators", "--shader", "--projection"}, 1);
+	std::vector<std::string> const properties = ArgumentReader::get(argc - 1, &argv[1], {"--operators", "--shader", "--projection", "--format", "--load", "--gallery", "--profile", "--vertex"}, 1);
 	debug("properties", properties);
 	operators = properties[ArgumentOperators];
+	loadName = properties[ArgumentLoad];
+	galleryName = properties[ArgumentGallery];
+	profileName = properties[ArgumentProfile];
 	rendererId = ArgumentReader::match<RendererType>(
 		{{"point", RendererPoint}, 
 		{"tri", RendererTriangle}, 
@@ -91,26 +110,78 @@ int main(int argc, char *argv[]){
 	projectionId = ArgumentReader::match<ProjectionType>(
 		{{"ortho", CameraOrthographic}, 
 		{"persp", CameraPerspective}}, properties[ArgumentProjection], CameraOrthographic);
+	formatId = ArgumentReader::match<ExportFormat>(
+		{{"obj", ExportObj}, 
+		{"ply", ExportPly}, 
+		{"poly", ExportPoly}, 
+		{"packed", ExportPackedPoly}}, properties[ArgumentFormat], ExportObj);
+	isPackedFormat = ArgumentReader::match<bool>(
+		{{"float", false}, 
+		{"packed", true}}, properties[ArgumentVertex], false);
 	}
 	
+	// gallery
+	Gallery gallery;
+	if(galleryName != ""){ // catalogue sheet, generated in parallel with shared suffixes, in file order
+		std::ifstream file(galleryName);
+		if(!file){
+			debug("Error: gallery stream file not found", galleryName);
+			return -1;
+		}
+		std::vector<std::string> const streams = Batch::read(file);
+		if(streams.empty()){
+			debug("Error: no gallery streams given");
+			return -1;
+		}
+		std::vector<BatchResult> sheet(streams.size());
+		{
+		WorkPool pool(0);
+		PolyhedronCache cache(GALLERY_CACHE_MEGABYTES << 20);
+		pool.run(streams.size(), [&](std::size_t s){ sheet[s] = Batch::generate(streams[s], &cache); });
+		}
+		for(BatchResult &result : sheet){
+			if(!result.isGenerated){
+				debug("Error: gallery stream failed", result.operators);
+				continue;
+			}
+			Mesh mesh(std::move(result.polyhedron.vertices), std::move(result.polyhedron.edges), std::move(result.polyhedron.faces));
+			gallery.add(mesh);
+		}
+		gallery.arrange();
+		debug("gallery shapes", gallery.getSize());
+	}
+	bool const isGallery = gallery.getSize() > 0;
+	bool const isQuantised = isPackedFormat && !isGallery; // sheets keep float vertices
+	
 	// check for operator stream
-	if(operators == ""){
+	if(!isGallery && operators == "" && loadName == ""){
 		debug("Error: no operator argument found");
 		return -1;
 	}
 	
-	// shape
-	std::vector<Mesh> polyhedra;
-	std::vector<Polyhedron> polydata = PolyhedronFactory::make(operators);
+	// shape, left empty under a gallery, which draws from its own buffers
+	std::vector<std::shared_ptr<Mesh>> polyhedra; // shared with the upload builder, so each keeps the derived data built for it
+	std::vector<Polyhedron> shapes;
+	if(isGallery) shapes.push_back(Polyhedron());
+	else if(loadName != ""){ // baked shape, mapped instead of regenerated
+		PolyFile file;
+		if(!file.open(loadName)) return -1;
+		operators = file.getOperators();
+		shapes.push_back(Polyhedron());
+		file.toPolyhedron(shapes.back());
+	}
+	else shapes = StreamPlan::history(operators); // the same operators as batches, galleries & the operator queue
 	{
-	for(Polyhedron poly : polydata) polyhedra.push_back(Mesh(poly.vertices, poly.edges, poly.faces));
+	for(Polyhedron &shape : shapes) polyhedra.push_back(std::make_shared<Mesh>(std::move(shape.vertices), std::move(shape.edges), std::move(shape.faces)));
 	if(polyhedra.empty()){
 		debug("Error: no polyhedra generated from stream");
 		return -1;
 	}
 	}
-	Mesh &polyhedron = polyhedra.back();
-	debug("shape", polyhedron);
+	Mesh &polyhedron = *polyhedra.back();
+	if(!isGallery) debug("shape", polyhedron);
+	WorkPool canonicalPool(0);
+	OperatorQueue operatorQueue(polyhedra.back(), &canonicalPool);
 	
 	// window
 	Window window("Polyhedra", WindowResize | WindowGraphic, WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_PERSEC, INPUT_PERSEC);
@@ -129,74 +200,140 @@ int main(int argc, char *argv[]){
 	projection.set(camera, window.getAspectRatio());
 	
 	// shader sources
-	Shader vertexShader, fragmentShader, solidwireGeometryShader, solidwireFragmentShader;
+	Shader vertexShader, fragmentShader, solidwireVertexShader, solidwireFragmentShader, galleryVertexShader, gallerySolidwireVertexShader;
 	{
 	std::string const basicVSrc = FileManager::get("shaders/basicVertex.glsl");
 	std::string const basicFSrc = FileManager::get("shaders/basicFragment.glsl");
-	std::string const solidwireGSrc = FileManager::get("shaders/solidwireGeometry.glsl");
+	std::string const solidwireVSrc = FileManager::get(isQuantised ? "shaders/solidwirePackedVertex.glsl" : "shaders/solidwireVertex.glsl");
 	std::string const solidwireFSrc = FileManager::get("shaders/solidwireFragment.glsl");
+	std::string const galleryVSrc = FileManager::get("shaders/galleryVertex.glsl");
+	std::string const gallerySolidwireVSrc = FileManager::get("shaders/gallerySolidwireVertex.glsl");
 	if(	basicVSrc == "" || basicFSrc == "" || 
-		solidwireGSrc == "" || solidwireFSrc == ""){
+		solidwireVSrc == "" || solidwireFSrc == "" || 
+		galleryVSrc == "" || gallerySolidwireVSrc == ""){
 		debug("Error: shader source files not found");
 		return -1;
 	}
 	vertexShader = Shader(ShaderVertex, std::vector<const char*>{basicVSrc.c_str()});
 	fragmentShader = Shader(ShaderFragment, std::vector<const char*>{basicFSrc.c_str()});
-	solidwireGeometryShader = Shader(ShaderGeometry, std::vector<const char*>{solidwireGSrc.c_str()});
+	solidwireVertexShader = Shader(ShaderVertex, std::vector<const char*>{solidwireVSrc.c_str()});
 	solidwireFragmentShader = Shader(ShaderFragment, std::vector<const char*>{solidwireFSrc.c_str()});
+	galleryVertexShader = Shader(ShaderVertex, std::vector<const char*>{galleryVSrc.c_str()});
+	gallerySolidwireVertexShader = Shader(ShaderVertex, std::vector<const char*>{gallerySolidwireVSrc.c_str()});
 	}
 	
-	// renderer components
-	Buffer vertexBuffer(BufferStatic, polyhedron.getSerialVertices().data(), sizeof(float) * polyhedron.getSerialVertices().size(), sizeof(float) * MODEL_MAX_VERTICES * 3);
-	vertexBuffer.update(polyhedron.getFanCentreVertices().data(), sizeof(float) * polyhedron.getFanCentreVertices().size(), sizeof(float) * polyhedron.getSerialVertices().size());
-	Buffer triangleBuffer(BufferStatic, polyhedron.getTriangularFaces().data(), sizeof(float) * polyhedron.getTriangularFaces().size(), sizeof(int) * MODEL_MAX_FACES);
-	Buffer lineBuffer(BufferStatic, polyhedron.getSerialEdges().data(), sizeof(float) * polyhedron.getSerialEdges().size(), sizeof(int) * MODEL_MAX_LINES);
-	Buffer wheelBuffer(BufferStatic, polyhedron.getFanFaces().data(), sizeof(float) * polyhedron.getFanFaces().size(), sizeof(int) * MODEL_MAX_WHEEL_FACES);
-	Index vertexIndex(vertexBuffer, 3, IndexFloat, IndexUnchanged, sizeof(float) * 3, 0);
-	Index triangleIndex(triangleBuffer, IndexUint, sizeof(int), 0);
-	Index lineIndex(lineBuffer, IndexUint, sizeof(int), 0);
-	Index wheelIndex(wheelBuffer, IndexUint, sizeof(int), 0);
+	// renderer components, laid out as uploads are, in float or packed formats
+	UploadPayload initial;
+	UploadPipeline::pack(polyhedron, initial, isQuantised);
+	Buffer vertexBuffer(BufferStatic, initial.getSectionData(UploadVertices), initial.getSectionBytes(UploadVertices));
+	Buffer triangleBuffer(BufferStatic, initial.getSectionData(UploadTriangles), initial.getSectionBytes(UploadTriangles));
+	Buffer lineBuffer(BufferStatic, initial.getSectionData(UploadLines), initial.getSectionBytes(UploadLines));
+	Buffer interleavedBuffer(BufferStatic, initial.getSectionData(UploadInterleaved), initial.getSectionBytes(UploadInterleaved));
+	Index vertexIndex = isQuantised ? 
+		Index(vertexBuffer, 3, IndexShort, IndexNormalised, sizeof(std::int16_t) * 4, 0) : 
+		Index(vertexBuffer, 3, IndexFloat, IndexUnchanged, sizeof(float) * 3, 0);
+	Index triangleIndex(triangleBuffer, initial.indexType, 0, 0);
+	Index lineIndex(lineBuffer, initial.indexType, 0, 0);
+	Index positionIndex = isQuantised ? 
+		Index(interleavedBuffer, 3, IndexShort, IndexNormalised, sizeof(MeshPackedVertex), (GLvoid*)offsetof(MeshPackedVertex, position)) : 
+		Index(interleavedBuffer, 3, IndexFloat, IndexUnchanged, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, position));
+	Index normalIndex = isQuantised ? 
+		Index(interleavedBuffer, 2, IndexShort, IndexNormalised, sizeof(MeshPackedVertex), (GLvoid*)offsetof(MeshPackedVertex, normal)) : 
+		Index(interleavedBuffer, 3, IndexFloat, IndexUnchanged, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, normal));
+	Index barycentricIndex = isQuantised ? 
+		Index(interleavedBuffer, 3, IndexUbyte, IndexNormalised, sizeof(MeshPackedVertex), (GLvoid*)offsetof(MeshPackedVertex, barycentric)) : 
+		Index(interleavedBuffer, 3, IndexFloat, IndexUnchanged, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, barycentric));
 	Program basicProgram(std::vector<Shader*>{ &vertexShader, &fragmentShader });
-	Program solidwireProgram(std::vector<Shader*>{ &vertexShader, &solidwireGeometryShader, &solidwireFragmentShader });
-	DrawArray pointDraw(DrawPoint, std::vector<Index*>{ &vertexIndex }, polyhedron.getSerialVertices().size() / 3);
-	DrawElements triangleDraw(DrawTriangle, std::vector<Index*>{ &vertexIndex }, triangleIndex, polyhedron.getTriangularFaces().size());
-	DrawElements lineDraw(DrawLine, std::vector<Index*>{ &vertexIndex }, lineIndex, polyhedron.getSerialEdges().size());
-	DrawElements solidwireDraw(DrawTriangle, std::vector<Index*>{ &vertexIndex }, wheelIndex, polyhedron.getFanFaces().size());
+	Program solidwireProgram(std::vector<Shader*>{ &solidwireVertexShader, &solidwireFragmentShader });
+	DrawArray pointDraw(DrawPoint, std::vector<Index*>{ &vertexIndex }, initial.pointTotal);
+	DrawMultiElements triangleDraw(DrawTriangle, std::vector<Index*>{ &vertexIndex }, triangleIndex, initial.triangleTotal);
+	DrawElements lineDraw(DrawLine, std::vector<Index*>{ &vertexIndex }, lineIndex, initial.lineTotal);
+	DrawMultiArray solidwireDraw(DrawTriangle, std::vector<Index*>{ &positionIndex, &normalIndex, &barycentricIndex }, initial.interleavedTotal);
+	UploadPipeline uploads(isQuantised);
+	float vertexScale = initial.scale; // folded into the model transform, so packed positions need no shader changes
+	std::vector<MeshCluster> clusters = std::move(initial.clusters); // of the drawn mesh, which lags the newest while uploading
+	std::vector<std::array<int, 2>> visibleRanges;
+	DetailChain detail;
+	detail.rebuild(polyhedra);
+	int shownMesh = polyhedra.size() - 1; // history position of the uploaded mesh
+	
+	// gallery components, one draw per renderer however many shapes the sheet holds
+	std::vector<float> const &galleryVertices = gallery.getSerialVertices();
+	std::vector<float> const &gallerySlots = gallery.getSerialSlots();
+	std::vector<int> const &galleryTriangles = gallery.getTriangularFaces();
+	std::vector<int> const &galleryEdges = gallery.getSerialEdges();
+	std::vector<MeshVertex> const &galleryInterleaved = gallery.getInterleavedVertices();
+	std::vector<float> const &galleryInterleavedSlots = gallery.getInterleavedSlots();
+	std::vector<std::array<float, 4>> const &galleryPlacements = gallery.getPlacements();
+	Buffer galleryVertexBuffer(BufferStatic, galleryVertices.data(), sizeof(float) * galleryVertices.size());
+	Buffer gallerySlotBuffer(BufferStatic, gallerySlots.data(), sizeof(float) * gallerySlots.size());
+	Buffer galleryTriangleBuffer(BufferStatic, galleryTriangles.data(), sizeof(int) * galleryTriangles.size());
+	Buffer galleryLineBuffer(BufferStatic, galleryEdges.data(), sizeof(int) * galleryEdges.size());
+	Buffer galleryInterleavedBuffer(BufferStatic, galleryInterleaved.data(), sizeof(MeshVertex) * galleryInterleaved.size());
+	Buffer galleryInterleavedSlotBuffer(BufferStatic, galleryInterleavedSlots.data(), sizeof(float) * galleryInterleavedSlots.size());
+	Buffer placementBuffer(BufferDynamic, galleryPlacements.data(), sizeof(std::array<float, 4>) * galleryPlacements.size());
+	TextureBuffer placementTexture(placementBuffer, TextureFloat4, GALLERY_PLACEMENT_UNIT);
+	Index galleryVertexIndex(galleryVertexBuffer, 3, IndexFloat, IndexUnchanged, sizeof(float) * 3, 0);
+	Index gallerySlotIndex(gallerySlotBuffer, 1, IndexFloat, IndexUnchanged, sizeof(float), 0);
+	Index galleryTriangleIndex(galleryTriangleBuffer, IndexUint, sizeof(int), 0);
+	Index galleryLineIndex(galleryLineBuffer, IndexUint, sizeof(int), 0);
+	Index galleryPositionIndex(galleryInterleavedBuffer, 3, IndexFloat, IndexUnchanged, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, position));
+	Index galleryNormalIndex(galleryInterleavedBuffer, 3, IndexFloat, IndexUnchanged, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, normal));
+	Index galleryBarycentricIndex(galleryInterleavedBuffer, 3, IndexFloat, IndexUnchanged, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, barycentric));
+	Index galleryInterleavedSlotIndex(galleryInterleavedSlotBuffer, 1, IndexFloat, IndexUnchanged, sizeof(float), 0);
+	Program galleryProgram(std::vector<Shader*>{ &galleryVertexShader, &fragmentShader });
+	Program gallerySolidwireProgram(std::vector<Shader*>{ &gallerySolidwireVertexShader, &solidwireFragmentShader });
+	DrawArray galleryPointDraw(DrawPoint, std::vector<Index*>{ &galleryVertexIndex, &gallerySlotIndex }, galleryVertices.size() / 3);
+	DrawElements galleryTriangleDraw(DrawTriangle, std::vector<Index*>{ &galleryVertexIndex, &gallerySlotIndex }, galleryTriangleIndex, galleryTriangles.size());
+	DrawElements galleryLineDraw(DrawLine, std::vector<Index*>{ &galleryVertexIndex, &gallerySlotIndex }, galleryLineIndex, galleryEdges.size());
+	DrawArray gallerySolidwireDraw(DrawTriangle, std::vector<Index*>{ &galleryPositionIndex, &galleryNormalIndex, &galleryBarycentricIndex, &galleryInterleavedSlotIndex }, galleryInterleaved.size());
 	
 	// renderers
-	std::list<Renderer> const renderers{
-		Renderer(basicProgram, pointDraw), 
-		Renderer(basicProgram, triangleDraw), 
-		Renderer(basicProgram, lineDraw), 
-		Renderer(solidwireProgram, solidwireDraw)
-	};
+	std::list<Renderer> const renderers = isGallery ? 
+		std::list<Renderer>{
+			Renderer(galleryProgram, galleryPointDraw), 
+			Renderer(galleryProgram, galleryTriangleDraw), 
+			Renderer(galleryProgram, galleryLineDraw), 
+			Renderer(gallerySolidwireProgram, gallerySolidwireDraw)} : 
+		std::list<Renderer>{
+			Renderer(basicProgram, pointDraw), 
+			Renderer(basicProgram, triangleDraw), 
+			Renderer(basicProgram, lineDraw), 
+			Renderer(solidwireProgram, solidwireDraw)};
+	std::vector<Program const*> const programs{ &basicProgram, &solidwireProgram, &galleryProgram, &gallerySolidwireProgram };
+	UniformBuffer transformBuffer(sizeof(TransformBlock), TRANSFORM_BINDING);
+	for(Program const *program : programs) program->setBlock("Transforms", transformBuffer);
 	std::list<Renderer>::const_iterator renderer = renderers.begin();
 	std::advance(renderer, rendererId);
 	
 	// uniforms
 	std::array<float, 3> rotateNormal = {-1.f / sqrt(2), 1.f / sqrt(2), 0};
 	float rotateMagnitude = 0;
+	std::array<float, 16> modelTransform = math::rotate(rotateMagnitude, rotateNormal); // of model positions, as clusters are culled
+	auto const getDrawnTransform = [&](){ // of drawn positions
+		std::array<float, 16> m = modelTransform;
+		for(int i = 0; i < 12; i++) m[i] *= vertexScale;
+		return m;
+	};
 	{
-	std::array<float, 16> screenSpace{
-		1,0,0,0,
-		0,1,0,0,
-		0,0,1,0,
-		0,0,0,1};
-	std::array<float, 16> viewProjection = camera.getViewProjection();
-	window.getScreenSpace(screenSpace[0], screenSpace[5], screenSpace[3], screenSpace[7]);
-	basicProgram.setUniform("vp", DataMatrix4(viewProjection, DataUnchanged));
-	solidwireProgram.setUniform("vp", DataMatrix4(viewProjection, DataUnchanged));
-	solidwireProgram.setUniform("screen", DataMatrix4(screenSpace, DataUnchanged));
-	std::array<float, 16> modelTransform = math::rotate(rotateMagnitude, rotateNormal);
-	basicProgram.setUniform("m", DataMatrix4(modelTransform, DataUnchanged));
-	solidwireProgram.setUniform("m", DataMatrix4(modelTransform, DataUnchanged));
+	TransformBlock const transforms{camera.getViewProjection(), getDrawnTransform()};
+	transformBuffer.update(&transforms, sizeof(TransformBlock), 0);
+	galleryProgram.setUniform("placements", DataInt(GALLERY_PLACEMENT_UNIT));
+	gallerySolidwireProgram.setUniform("placements", DataInt(GALLERY_PLACEMENT_UNIT));
 	}
 	
 	// loop
+	Profiler profiler;
+	std::size_t frameCalls = 0, frame = 0;
+	int visibleClusters = 0; // reported with the profile summary, as it changes nearly every frame while the view moves
+	CallCounter::take(); // setup calls aren't counted against the first frame
 	window.timer();
 	bool isRunning = true;
 	while(isRunning){
 		
+		// pacing
+		window.wait();
+		
 		// input
 		switch(window.get()){
 			case WindowExit:
@@ -204,10 +341,6 @@ int main(int argc, char *argv[]){
 				break;
 			case WindowResized:
 				projection.set(camera, window.getAspectRatio());
-				std::array<float, 16> screenSpace;
-				screenSpace[0] = screenSpace[5] = screenSpace[10] = screenSpace[15] = 1;
-				window.getScreenSpace(screenSpace[0], screenSpace[5], screenSpace[3], screenSpace[7]);
-				solidwireProgram.setUniform("screen", DataMatrix4(screenSpace, DataUnchanged));
 				break;
 		}
 		
@@ -231,19 +364,63 @@ int main(int argc, char *argv[]){
 			camera.input(input.getPress(InputSelect), input.getHold(InputTurn), input.getPress(InputRelease), move, look);
 			
 			// view
-			basicProgram.setUniform("vp", DataMatrix4(camera.getViewProjection(), DataUnchanged));
-			solidwireProgram.setUniform("vp", DataMatrix4(camera.getViewProjection(), DataUnchanged));
+			profiler.begin(ProfileUpload);
+			std::array<float, 16> const viewProjection = camera.getViewProjection();
+			transformBuffer.update(viewProjection.data(), sizeof(viewProjection), offsetof(TransformBlock, vp));
+			
+			// upload
+			if(UploadPayload const *payload = uploads.step({&vertexBuffer, &triangleBuffer, &lineBuffer, &interleavedBuffer})){
+				pointDraw.recount(payload->pointTotal);
+				triangleDraw.recount(payload->triangleTotal);
+				lineDraw.recount(payload->lineTotal);
+				solidwireDraw.recount(payload->interleavedTotal);
+				debug("new mesh count", payload->interleavedTotal);
+				debug("upload bytes", payload->offsets[UploadSectionTotal]);
+				debug("triangle ACMR", payload->triangleACMR);
+				clusters = payload->clusters;
+				triangleDraw.retype(payload->indexType);
+				lineDraw.retype(payload->indexType);
+				if(payload->scale != vertexScale){
+					vertexScale = payload->scale;
+					std::array<float, 16> const drawnTransform = getDrawnTransform();
+					transformBuffer.update(drawnTransform.data(), sizeof(drawnTransform), offsetof(TransformBlock, m));
+				}
+			}
+			
+			// culling, of the single shape's clusters against this frame's view
+			if(!isGallery){
+				visibleClusters = Culling::cull(clusters, viewProjection, modelTransform, visibleRanges);
+				triangleDraw.range(visibleRanges, 3);
+				solidwireDraw.range(visibleRanges, 3);
+			}
+			profiler.end(ProfileUpload);
 			
 			// display
+			profiler.begin(ProfileDraw);
+			profiler.beginGPU();
 			window.clear();
 			renderer->display();
+			profiler.endGPU();
 			window.swap();
+			profiler.end(ProfileDraw);
+			
+			// profile
+			std::size_t const calls = CallCounter::take();
+			if(calls != frameCalls) debug("GL calls per frame", calls);
+			frameCalls = calls;
+			profiler.endFrame(calls);
+			if(++frame % PROFILE_SUMMARY_FRAMES == 0){
+				std::string summary = "Polyhedra | " + profiler.getSummary(PROFILE_SUMMARY_FRAMES);
+				if(!isGallery) summary += " | clusters " + std::to_string(visibleClusters) + " / " + std::to_string(clusters.size());
+				window.title(summary);
+			}
 		}
 		
 		// simulation
 		if(window.cap(WindowInput)){
 			
 			// movement
+			profiler.begin(ProfileInput);
 			float look[2] = { 0, 0 };
 			float move[3] = {
 				(float)(input.getHold(InputRight) - input.getHold(InputLeft)), 
@@ -263,86 +440,78 @@ int main(int argc, char *argv[]){
 			// model
 			if(input.getHold(InputSpin)){
 				rotateMagnitude += MODEL_ROTATE_SENS;
-				std::array<float, 16> modelTransform = math::rotate(rotateMagnitude, rotateNormal);
-				basicProgram.setUniform("m", DataMatrix4(modelTransform, DataUnchanged));
-				solidwireProgram.setUniform("m", DataMatrix4(modelTransform, DataUnchanged));
+				modelTransform = math::rotate(rotateMagnitude, rotateNormal);
+				std::array<float, 16> const drawnTransform = getDrawnTransform();
+				transformBuffer.update(drawnTransform.data(), sizeof(drawnTransform), offsetof(TransformBlock, m));
 			}
+			profiler.end(ProfileInput);
 			
 			// polyhedron
+			if(isGallery) continue; // sheets are fixed; operators & export apply to a single shape
+			profiler.begin(ProfileMutate);
 			bool isMeshChanged = false;
 			if(input.getPress(InputDual)){
 				debug("Operator dual & reset testing");
-				polydata.push_back(polydata.back()); // operate on polyhedron
-				PolyhedronFactory::mutate(polydata.back(), 'd');
-				polyhedra.push_back(Mesh(polydata.back().vertices, polydata.back().edges, polydata.back().faces));
-				operators = "d" + operators;
-				isMeshChanged = true;
+				operatorQueue.submit('d');
 			}
 			if(input.getPress(InputAmbo)){
 				debug("Operator ambo");
-				polydata.push_back(polydata.back());
-				PolyhedronFactory::mutate(polydata.back(), 'a');
-				polyhedra.push_back(Mesh(polydata.back().vertices, polydata.back().edges, polydata.back().faces));
-				operators = "a" + operators;
-				isMeshChanged = true;
+				operatorQueue.submit('a');
 			}
 			if(input.getPress(InputAkis)){
 				debug("Operator akis");
-				polydata.push_back(polydata.back());
-				PolyhedronFactory::mutate(polydata.back(), 'k');
-				polyhedra.push_back(Mesh(polydata.back().vertices, polydata.back().edges, polydata.back().faces));
-				operators = "k" + operators;
-				isMeshChanged = true;
+				operatorQueue.submit('k');
 			}
 			if(input.getPress(InputGyro)){
 				debug("Operator gyro");
-				polydata.push_back(polydata.back());
-				PolyhedronFactory::mutate(polydata.back(), 'g');
-				polyhedra.push_back(Mesh(polydata.back().vertices, polydata.back().edges, polydata.back().faces));
-				operators = "g" + operators;
-				isMeshChanged = true;
+				operatorQueue.submit('g');
 			}
 			if(input.getPress(InputCanon)){
 				debug("Operator canon");
-				polydata.push_back(polydata.back());
-				PolyhedronFactory::mutate(polydata.back(), 'c');
-				polyhedra.push_back(Mesh(polydata.back().vertices, polydata.back().edges, polydata.back().faces));
-				operators = "c" + operators;
+				operatorQueue.submit('c');
+			}
+			OperatorResult result;
+			while(operatorQueue.poll(result)){ // operators finish in order, off this thread
+				debug("operator seconds", result.seconds);
+				polyhedra.push_back(std::move(result.mesh));
+				operators = result.op + operators;
 				isMeshChanged = true;
 			}
-			if(input.getPress(InputRevert)){
-				if(polyhedra.size() > 1){
+			if(input.getPress(InputRevert)){ // cancels unfinished operators first, otherwise undoes the last one
+				if(operatorQueue.isBusy()) debug("Operators cancelled");
+				else if(polyhedra.size() > 1){
 					polyhedra.pop_back();
-					polydata.pop_back();
 					operators.erase(operators.begin());
 					isMeshChanged = true;
 				}
+				operatorQueue.cancel(polyhedra.back()); // a handle; the worker copies it only when another operator runs
 			}
-			if(isMeshChanged){ // update buffers
-				Mesh &mesh = polyhedra.back();
-				vertexBuffer.update(mesh.getSerialVertices().data(), sizeof(float) * mesh.getSerialVertices().size(), 0);
-				vertexBuffer.update(mesh.getFanCentreVertices().data(), sizeof(float) * mesh.getFanCentreVertices().size(), 
-					sizeof(float) * mesh.getSerialVertices().size());
-				triangleBuffer.update(mesh.getTriangularFaces().data(), sizeof(int) * mesh.getTriangularFaces().size(), 0);
-				lineBuffer.update(mesh.getSerialEdges().data(), sizeof(int) * mesh.getSerialEdges().size(), 0);
-				wheelBuffer.update(mesh.getFanFaces().data(), sizeof(int) * mesh.getFanFaces().size(), 0);
-				pointDraw.recount(mesh.getSerialVertices().size() / 3);
-				triangleDraw.recount(mesh.getTriangularFaces().size());
-				lineDraw.recount(mesh.getSerialEdges().size());
-				solidwireDraw.recount(mesh.getFanFaces().size());
+			if(isMeshChanged){
+				detail.rebuild(polyhedra);
 				debug("new operator stream", operators);
-				debug("new mesh count", mesh.getFanFaces().size());
+			}
+			
+			// detail, an ancestor in place of the newest shape while it's too small on screen for all its triangles
+			float screenWidth, screenHeight, screenX, screenY;
+			window.getScreenSpace(screenWidth, screenHeight, screenX, screenY);
+			int const detailMesh = detail.select(camera.getScreenRadius({0.f, 0.f, 0.f}, detail.getRadius(), screenHeight));
+			if(isMeshChanged || detailMesh != shownMesh){ // derived data is built off this thread & uploaded over the following frames
+				uploads.submit(polyhedra[detailMesh]);
+				if(detailMesh != shownMesh) debug("detail level", std::to_string(detail.getLevel()) + " / " + std::to_string(detail.getLevelTotal()));
+				shownMesh = detailMesh;
 			}
 			if(input.getPress(InputExport)){
-				Mesh &mesh = polyhedra.back();
-				std::vector<float> vertices = mesh.getSerialVertices();
-				for(float v : mesh.getFanCentreVertices()) vertices.push_back(v);
-				std::vector<int> triangles = mesh.getFanFaces();
-				exportData(operators.c_str(), vertices, triangles);
-				debug("exported data");
+				Mesh const &mesh = *polyhedra.back();
+				std::string noCanonName = operators; // named by topology, as canonical passes only move vertices
+				noCanonName.erase(std::remove(noCanonName.begin(), noCanonName.end(), 'c'), noCanonName.end());
+				std::string const fileName = noCanonName + Exporter::getExtension(formatId);
+				if(Exporter::write(fileName, formatId, noCanonName, mesh.getIndexVertices(), mesh.getIndexEdges(), mesh.getIndexFaces()))
+					debug("export success", fileName);
 			}
+			profiler.end(ProfileMutate);
 		}
 	}
+	if(profileName != "" && profiler.write(profileName)) debug("profile written", profileName);
 	
 	return 0;
 }
\ No newline at end of file
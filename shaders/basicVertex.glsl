@@ -1,7 +1,9 @@
 #version 330 core
 layout (location = 0) in vec3 pos;
-uniform mat4 m;
-uniform mat4 vp;
+layout (std140) uniform Transforms{
+	mat4 vp;
+	mat4 m;
+};
 void main(){
 	gl_Position = vp * m * vec4(pos, 1);
 }
\ No newline at end of file
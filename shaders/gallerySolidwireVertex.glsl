@@ -0,0 +1,18 @@
+#version 330 core
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec3 normal;
+layout (location = 2) in vec3 barycentric;
+layout (location = 3) in float slot;
+layout (std140) uniform Transforms{
+	mat4 vp;
+	mat4 m;
+};
+uniform samplerBuffer placements;
+out vec3 vert_normal;
+out vec3 vert_barycentric;
+void main(){
+	vec4 placement = texelFetch(placements, int(slot));
+	vert_normal = mat3(m) * normal;
+	vert_barycentric = barycentric;
+	gl_Position = vp * vec4(placement.xyz + placement.w * (m * vec4(pos, 1)).xyz, 1);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 330 core
+layout (location = 0) in vec3 pos;
+layout (location = 1) in float slot;
+layout (std140) uniform Transforms{
+	mat4 vp;
+	mat4 m;
+};
+uniform samplerBuffer placements;
+void main(){
+	vec4 placement = texelFetch(placements, int(slot));
+	gl_Position = vp * vec4(placement.xyz + placement.w * (m * vec4(pos, 1)).xyz, 1);
+}
\ No newline at end of file
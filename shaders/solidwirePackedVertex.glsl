@@ -0,0 +1,21 @@
+#version 330 core
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec2 normal;
+layout (location = 2) in vec3 barycentric;
+layout (std140) uniform Transforms{
+	mat4 vp;
+	mat4 m;
+};
+out vec3 vert_normal;
+out vec3 vert_barycentric;
+vec3 unfold(vec2 e){ // octahedral normal
+	vec3 n = vec3(e, 1 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0);
+	n.xy += vec2(n.x >= 0 ? -t : t, n.y >= 0 ? -t : t);
+	return normalize(n);
+}
+void main(){
+	vert_normal = mat3(m) * unfold(normal);
+	vert_barycentric = barycentric;
+	gl_Position = vp * m * vec4(pos, 1);
+}
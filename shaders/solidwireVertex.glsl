@@ -0,0 +1,15 @@
+#version 330 core
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec3 normal;
+layout (location = 2) in vec3 barycentric;
+layout (std140) uniform Transforms{
+	mat4 vp;
+	mat4 m;
+};
+out vec3 vert_normal;
+out vec3 vert_barycentric;
+void main(){
+	vert_normal = mat3(m) * normal;
+	vert_barycentric = barycentric;
+	gl_Position = vp * m * vec4(pos, 1);
+}
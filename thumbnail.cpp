@@ -0,0 +1,260 @@
+#include "lib/offscreen.hpp" // windowless rendering
+#include "lib/shader.hpp" // scene display
+#include "lib/model.hpp" // polyhedron model representation
+#include "lib/batch.hpp" // stream reading & generation
+#include "lib/workpool.hpp" // parallel generation
+#include "lib/polycache.hpp" // shared suffix reuse
+#include "source/maths.hpp" // model rotation
+#include "utils/argument.hpp" // argument fetching
+#include "utils/usage.hpp" // timing
+#include "utils/debug.hpp" // debugging
+#include "utils/filemanager.hpp" // file fetching
+
+#include <vector> // stream listing
+#include <array> // transforms
+#include <list> // list renderers
+#include <string> // operator streams
+#include <iostream> // standard input
+#include <fstream> // stream file input
+#include <cmath> // shape radii
+#include <cstddef> // interleaved attribute offsets
+#include <stdio.h> // report formatting
+
+// indexing
+enum ThumbnailArgument{
+	ThumbnailInput, // operator stream file
+	ThumbnailOutput, // image output directory
+	ThumbnailSize, // image width & height
+	ThumbnailRenderer, // model renderer id
+	ThumbnailThreads, // worker thread total
+	ThumbnailCache, // suffix cache megabytes
+	ThumbnailVertex // vertex format id
+};
+enum RendererType{
+	RendererPoint,
+	RendererTriangle,
+	RendererLine,
+	RendererSolidwire
+};
+
+#define THUMBNAIL_SIZE 256
+#define THUMBNAIL_MAX_SIZE 16384 // widest image, within common renderbuffer limits
+#define THUMBNAIL_USAGE "Usage: thumbnail.exe [streamFile] [--input streamFile] [--output directory] [--size pixels] [--shader point|tri|line|solid]\n" \
+	"\t[--threads count] [--cache megabytes] [--vertex float|packed], size being 1 to 16384 and counts unsigned whole numbers\n"
+#define THUMBNAIL_CACHE_MEGABYTES 256
+#define THUMBNAIL_FILL .9f // shape radius as a fraction of the image's half-width
+#define THUMBNAIL_ROTATION .6f // fixed view, turned about the same axis main spins models around
+
+#define TRANSFORM_BINDING 0 // uniform block binding point shared by every program
+
+// data
+struct TransformBlock{ // std140 layout of the shaders' Transforms block
+	std::array<float, 16> vp;
+	std::array<float, 16> m;
+};
+
+int main(int argc, char *argv[]){
+
+	// arguments
+	std::vector<std::string> const properties = ArgumentReader::get(argc - 1, &argv[1], {"--input", "--output", "--size", "--shader", "--threads", "--cache", "--vertex"}, 1);
+	std::string const directory = properties[ThumbnailOutput] == "" ? "." : properties[ThumbnailOutput];
+	RendererType const rendererId = ArgumentReader::match<RendererType>(
+		{{"point", RendererPoint},
+		{"tri", RendererTriangle},
+		{"line", RendererLine},
+		{"solid", RendererSolidwire}}, properties[ThumbnailRenderer], RendererSolidwire);
+	std::size_t sizeCount, threads, cacheMegabytes;
+	if(!ArgumentReader::count(properties[ThumbnailSize], THUMBNAIL_SIZE, sizeCount) || sizeCount == 0 || sizeCount > THUMBNAIL_MAX_SIZE ||
+		!ArgumentReader::count(properties[ThumbnailThreads], 0, threads) || !ArgumentReader::count(properties[ThumbnailCache], THUMBNAIL_CACHE_MEGABYTES, cacheMegabytes)){
+		fprintf(stderr, "%s", THUMBNAIL_USAGE);
+		return -1;
+	}
+	int const size = sizeCount;
+	bool const isQuantised = ArgumentReader::match<bool>({{"float", false}, {"packed", true}}, properties[ThumbnailVertex], false);
+
+	// streams
+	std::vector<std::string> streams;
+	if(properties[ThumbnailInput] == "" || properties[ThumbnailInput] == "-") streams = Batch::read(std::cin);
+	else{
+		std::ifstream file(properties[ThumbnailInput]);
+		if(!file){
+			debug("Error: operator stream file not found", properties[ThumbnailInput]);
+			return -1;
+		}
+		streams = Batch::read(file);
+	}
+	if(streams.empty()){
+		debug("Error: no operator streams given");
+		return -1;
+	}
+
+	// generation, in parallel ahead of the single GL thread
+	Stopwatch total;
+	std::vector<BatchResult> results(streams.size());
+	{
+	WorkPool pool(threads);
+	PolyhedronCache cache(cacheMegabytes << 20);
+	pool.run(streams.size(), [&](std::size_t s){ results[s] = Batch::generate(streams[s], cacheMegabytes > 0 ? &cache : nullptr); });
+	}
+	double const generateSeconds = total.getSeconds();
+
+	// context
+	Offscreen offscreen(size, size);
+	if(!offscreen.isValid()){
+		debug("Error: offscreen context not created");
+		return -1;
+	}
+
+	// shader sources
+	Shader vertexShader, fragmentShader, solidwireVertexShader, solidwireFragmentShader;
+	{
+	std::string const basicVSrc = FileManager::get("shaders/basicVertex.glsl");
+	std::string const basicFSrc = FileManager::get("shaders/basicFragment.glsl");
+	std::string const solidwireVSrc = FileManager::get(isQuantised ? "shaders/solidwirePackedVertex.glsl" : "shaders/solidwireVertex.glsl");
+	std::string const solidwireFSrc = FileManager::get("shaders/solidwireFragment.glsl");
+	if(	basicVSrc == "" || basicFSrc == "" ||
+		solidwireVSrc == "" || solidwireFSrc == ""){
+		debug("Error: shader source files not found");
+		return -1;
+	}
+	vertexShader = Shader(ShaderVertex, std::vector<const char*>{basicVSrc.c_str()});
+	fragmentShader = Shader(ShaderFragment, std::vector<const char*>{basicFSrc.c_str()});
+	solidwireVertexShader = Shader(ShaderVertex, std::vector<const char*>{solidwireVSrc.c_str()});
+	solidwireFragmentShader = Shader(ShaderFragment, std::vector<const char*>{solidwireFSrc.c_str()});
+	}
+
+	// renderer components, refilled per shape
+	Buffer vertexBuffer(BufferStream, NULL, 0);
+	Buffer triangleBuffer(BufferStream, NULL, 0);
+	Buffer lineBuffer(BufferStream, NULL, 0);
+	Buffer interleavedBuffer(BufferStream, NULL, 0);
+	Index vertexIndex = isQuantised ? 
+		Index(vertexBuffer, 3, IndexShort, IndexNormalised, sizeof(std::int16_t) * 4, 0) : 
+		Index(vertexBuffer, 3, IndexFloat, IndexUnchanged, sizeof(float) * 3, 0);
+	Index triangleIndex(triangleBuffer, IndexUint, sizeof(int), 0);
+	Index lineIndex(lineBuffer, IndexUint, sizeof(int), 0);
+	Index positionIndex = isQuantised ? 
+		Index(interleavedBuffer, 3, IndexShort, IndexNormalised, sizeof(MeshPackedVertex), (GLvoid*)offsetof(MeshPackedVertex, position)) : 
+		Index(interleavedBuffer, 3, IndexFloat, IndexUnchanged, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, position));
+	Index normalIndex = isQuantised ? 
+		Index(interleavedBuffer, 2, IndexShort, IndexNormalised, sizeof(MeshPackedVertex), (GLvoid*)offsetof(MeshPackedVertex, normal)) : 
+		Index(interleavedBuffer, 3, IndexFloat, IndexUnchanged, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, normal));
+	Index barycentricIndex = isQuantised ? 
+		Index(interleavedBuffer, 3, IndexUbyte, IndexNormalised, sizeof(MeshPackedVertex), (GLvoid*)offsetof(MeshPackedVertex, barycentric)) : 
+		Index(interleavedBuffer, 3, IndexFloat, IndexUnchanged, sizeof(MeshVertex), (GLvoid*)offsetof(MeshVertex, barycentric));
+	Program basicProgram(std::vector<Shader*>{ &vertexShader, &fragmentShader });
+	Program solidwireProgram(std::vector<Shader*>{ &solidwireVertexShader, &solidwireFragmentShader });
+	DrawArray pointDraw(DrawPoint, std::vector<Index*>{ &vertexIndex }, 0);
+	DrawElements triangleDraw(DrawTriangle, std::vector<Index*>{ &vertexIndex }, triangleIndex, 0);
+	DrawElements lineDraw(DrawLine, std::vector<Index*>{ &vertexIndex }, lineIndex, 0);
+	DrawArray solidwireDraw(DrawTriangle, std::vector<Index*>{ &positionIndex, &normalIndex, &barycentricIndex }, 0);
+	UniformBuffer transformBuffer(sizeof(TransformBlock), TRANSFORM_BINDING);
+	basicProgram.setBlock("Transforms", transformBuffer);
+	solidwireProgram.setBlock("Transforms", transformBuffer);
+
+	// renderers
+	std::list<Renderer> const renderers{
+		Renderer(basicProgram, pointDraw),
+		Renderer(basicProgram, triangleDraw),
+		Renderer(basicProgram, lineDraw),
+		Renderer(solidwireProgram, solidwireDraw)
+	};
+	std::list<Renderer>::const_iterator renderer = renderers.begin();
+	std::advance(renderer, rendererId);
+
+	// thumbnails
+	Stopwatch rendering;
+	std::array<float, 3> const rotateNormal = {-1.f / sqrt(2), 1.f / sqrt(2), 0};
+	TransformBlock transforms{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 1}, math::rotate(THUMBNAIL_ROTATION, rotateNormal)}; // orthographic, looking down -z
+	std::array<float, 16> const rotation = transforms.m;
+	int failures = 0;
+	for(BatchResult &result : results){
+		if(!result.isGenerated){
+			debug("Error: stream failed", result.operators);
+			failures++;
+			continue;
+		}
+		Mesh mesh(std::move(result.polyhedron.vertices), std::move(result.polyhedron.edges), std::move(result.polyhedron.faces));
+
+		// upload, only what the renderer draws
+		float const vertexScale = isQuantised ? mesh.getPackedScale() : 1.f;
+		if(isQuantised){
+			if(rendererId == RendererSolidwire){
+				std::vector<MeshPackedVertex> const &interleaved = mesh.getPackedInterleavedVertices();
+				interleavedBuffer.reserve(sizeof(MeshPackedVertex) * interleaved.size());
+				interleavedBuffer.update(interleaved.data(), sizeof(MeshPackedVertex) * interleaved.size(), 0);
+				solidwireDraw.recount(interleaved.size());
+			}
+			else{
+				std::vector<std::int16_t> const &vertices = mesh.getPackedVertices();
+				vertexBuffer.reserve(sizeof(std::int16_t) * vertices.size());
+				vertexBuffer.update(vertices.data(), sizeof(std::int16_t) * vertices.size(), 0);
+				pointDraw.recount(vertices.size() / 4);
+				bool const isShort = mesh.hasShortIndices();
+				if(rendererId == RendererTriangle){
+					std::vector<std::uint16_t> const &shortTriangles = mesh.getShortTriangularFaces();
+					std::vector<int> const &triangles = mesh.getTriangularFaces();
+					triangleBuffer.reserve(isShort ? sizeof(std::uint16_t) * shortTriangles.size() : sizeof(int) * triangles.size());
+					if(isShort) triangleBuffer.update(shortTriangles.data(), sizeof(std::uint16_t) * shortTriangles.size(), 0);
+					else triangleBuffer.update(triangles.data(), sizeof(int) * triangles.size(), 0);
+					triangleDraw.retype(isShort ? IndexUshort : IndexUint);
+					triangleDraw.recount(triangles.size());
+				}
+				if(rendererId == RendererLine){
+					std::vector<std::uint16_t> const &shortLines = mesh.getShortSerialEdges();
+					std::vector<int> const &lines = mesh.getSerialEdges();
+					lineBuffer.reserve(isShort ? sizeof(std::uint16_t) * shortLines.size() : sizeof(int) * lines.size());
+					if(isShort) lineBuffer.update(shortLines.data(), sizeof(std::uint16_t) * shortLines.size(), 0);
+					else lineBuffer.update(lines.data(), sizeof(int) * lines.size(), 0);
+					lineDraw.retype(isShort ? IndexUshort : IndexUint);
+					lineDraw.recount(lines.size());
+				}
+			}
+		}
+		else if(rendererId == RendererSolidwire){
+			std::vector<MeshVertex> const &interleaved = mesh.getInterleavedVertices();
+			interleavedBuffer.reserve(sizeof(MeshVertex) * interleaved.size());
+			interleavedBuffer.update(interleaved.data(), sizeof(MeshVertex) * interleaved.size(), 0);
+			solidwireDraw.recount(interleaved.size());
+		}
+		else{
+			std::vector<float> const &vertices = mesh.getSerialVertices();
+			vertexBuffer.reserve(sizeof(float) * vertices.size());
+			vertexBuffer.update(vertices.data(), sizeof(float) * vertices.size(), 0);
+			pointDraw.recount(vertices.size() / 3);
+			if(rendererId == RendererTriangle){
+				std::vector<int> const &triangles = mesh.getTriangularFaces();
+				triangleBuffer.reserve(sizeof(int) * triangles.size());
+				triangleBuffer.update(triangles.data(), sizeof(int) * triangles.size(), 0);
+				triangleDraw.recount(triangles.size());
+			}
+			if(rendererId == RendererLine){
+				std::vector<int> const &lines = mesh.getSerialEdges();
+				lineBuffer.reserve(sizeof(int) * lines.size());
+				lineBuffer.update(lines.data(), sizeof(int) * lines.size(), 0);
+				lineDraw.recount(lines.size());
+			}
+		}
+
+		// framing, each shape scaled to fill the image
+		float radius = 0;
+		for(std::array<float, 3> const &v : mesh.getIndexVertices()) radius = std::max(radius, std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]));
+		float const scale = THUMBNAIL_FILL / (radius > 0 ? radius : 1.f);
+		for(int i = 0; i < 12; i++) transforms.m[i] = rotation[i] * scale * vertexScale;
+		transformBuffer.update(&transforms, sizeof(TransformBlock), 0);
+
+		// drawing
+		offscreen.clear();
+		renderer->display();
+		offscreen.read(directory + "/" + result.operators + ".png");
+	}
+	offscreen.flush();
+	double const renderSeconds = rendering.getSeconds();
+	failures += offscreen.getFailed();
+
+	// report
+	printf("%i images, %i failed, %ix%i, generation %.3f s, rendering %.3f s, %.1f images/s\n",
+		offscreen.getWritten(), failures, size, size, generateSeconds, renderSeconds, renderSeconds > 0 ? offscreen.getWritten() / renderSeconds : 0.0);
+
+	return failures == 0 ? 0 : 1;
+}
@@ -1,6 +1,10 @@
 #include <vector> // argument listing & accessing
 #include <tuple> // argument-index pairing
 #include <algorithm> // argument searching
+#include <string> // argument values
+#include <cstdlib> // number parsing
+#include <cerrno> // number range
+#include <cctype> // digit checking
 
 class ArgumentReader{
 	static std::pair<int, std::string> getPair(const char *id, const char *value, std::vector<std::string> const &ids){
@@ -28,6 +32,19 @@ public:
 		}
 		return arguments;
 	}
+	static bool count(std::string const &value, std::size_t defaultValue, std::size_t &number){ // unsigned decimal, or the default when absent
+		if(value == ""){
+			number = defaultValue;
+			return true;
+		}
+		if(!isdigit((unsigned char)value[0])) return false;
+		char *end = NULL;
+		errno = 0;
+		unsigned long long const parsed = strtoull(value.c_str(), &end, 10);
+		if(*end != '\0' || errno == ERANGE) return false;
+		number = parsed;
+		return true;
+	}
 	template <typename T>
 	static T match(std::vector<std::pair<std::string, T>> const &types, std::string const &target, T defaultValue){
 		typename std::vector<std::pair<std::string, T>>::const_iterator select = std::find_if(types.begin(), types.end(), 
@@ -0,0 +1,223 @@
+#ifndef HEADER_BAKE
+#define HEADER_BAKE
+
+#include "seeds.hpp" // fixed polyhedra & seed tables
+#include "../source/polyhedra.hpp" // run-time conversion
+
+#include <array> // fixed storage
+
+// half-edge adjacency of a fixed polyhedron, as Topology::link finds it, so operators place & order their output the same way
+template <int V, int F, int I>
+struct FixedLinks{
+	std::array<int, I> faceOf{}, nexts{}, prevs{}, twins{}, edgeOf{};
+	std::array<int, V> vertexEdges{};
+	int edgeTotal = 0;
+	constexpr FixedLinks(FixedPolyhedron<V, F, I> const &p){
+		for(int f = 0; f < F; f++){
+			for(int h = p.faceOffsets[f]; h < p.faceOffsets[f + 1]; h++){
+				faceOf[h] = f;
+				nexts[h] = h + 1 == p.faceOffsets[f + 1] ? p.faceOffsets[f] : h + 1;
+				prevs[h] = h == p.faceOffsets[f] ? p.faceOffsets[f + 1] - 1 : h - 1;
+			}
+		}
+
+		// twins through outgoing half-edges grouped by origin vertex (counting sort)
+		std::array<int, V + 1> outOffsets{};
+		for(int h = 0; h < I; h++) outOffsets[p.indices[h] + 1]++;
+		for(int v = 0; v < V; v++) outOffsets[v + 1] += outOffsets[v];
+		std::array<int, I> outgoing{};
+		std::array<int, V> fill{};
+		for(int v = 0; v < V; v++) fill[v] = outOffsets[v];
+		for(int h = 0; h < I; h++) outgoing[fill[p.indices[h]]++] = h;
+		for(int h = 0; h < I; h++){
+			twins[h] = -1;
+			int const a = p.indices[h], b = p.indices[nexts[h]];
+			for(int o = outOffsets[b]; o < outOffsets[b + 1]; o++){
+				if(p.indices[nexts[outgoing[o]]] == a){
+					twins[h] = outgoing[o];
+					break;
+				}
+			}
+		}
+
+		// undirected edges & vertex entry points
+		for(int h = 0; h < I; h++) edgeOf[h] = -1;
+		for(int h = 0; h < I; h++){
+			if(edgeOf[h] != -1) continue;
+			edgeOf[h] = edgeTotal;
+			if(twins[h] != -1) edgeOf[twins[h]] = edgeTotal;
+			edgeTotal++;
+		}
+		for(int v = 0; v < V; v++) vertexEdges[v] = -1;
+		for(int h = 0; h < I; h++){
+			int &entry = vertexEdges[p.indices[h]];
+			if(entry == -1 || twins[h] == -1) entry = h; // as Topology::link, so open rings start at the boundary
+		}
+	}
+	constexpr int rotate(int h) const { return twins[prevs[h]]; } // next outgoing half-edge anticlockwise around the origin
+};
+
+// geometry shared by the operators, in the same arithmetic order as Topology's
+struct FixedGeometry{
+	static constexpr std::array<float, 3> lerp(std::array<float, 3> const &a, std::array<float, 3> const &b, float t){
+		return {a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t, a[2] + (b[2] - a[2]) * t};
+	}
+	template <int V, int F, int I>
+	static constexpr std::array<float, 3> getFaceCentre(FixedPolyhedron<V, F, I> const &p, int f){
+		std::array<float, 3> centre = {0, 0, 0};
+		for(int h = p.faceOffsets[f]; h < p.faceOffsets[f + 1]; h++)
+			for(int i = 0; i < 3; i++) centre[i] += p.vertices[p.indices[h]][i];
+		float const size = p.faceOffsets[f + 1] - p.faceOffsets[f];
+		for(int i = 0; i < 3; i++) centre[i] /= size;
+		return centre;
+	}
+	template <int V, int F, int I>
+	static constexpr std::array<std::array<int, 2>, I / 2> getEdges(FixedPolyhedron<V, F, I> const &p){ // numbered & directed by each edge's first half-edge, as Topology::toPolyhedron writes them
+		FixedLinks<V, F, I> const links(p);
+		std::array<std::array<int, 2>, I / 2> edges{};
+		for(int h = 0; h < I; h++){
+			if(links.twins[h] != -1 && links.twins[h] < h) continue;
+			edges[links.edgeOf[h]] = {p.indices[h], p.indices[links.nexts[h]]};
+		}
+		return edges;
+	}
+};
+
+// operators by notation letter, each output's totals following from its counting rule; closed polyhedra only
+template <char Op>
+struct FixedOperator{
+	static_assert(Op == 0, "operator has no compile-time form; c relaxes iteratively, so canonical shapes are generated at run time");
+};
+
+template <>
+struct FixedOperator<'d'>{ // face centres, joined anticlockwise around each old vertex
+	template <int V, int F, int I>
+	static constexpr FixedPolyhedron<F, V, I> apply(FixedPolyhedron<V, F, I> const &p){
+		FixedLinks<V, F, I> const links(p);
+		FixedPolyhedron<F, V, I> out{};
+		for(int f = 0; f < F; f++) out.vertices[f] = FixedGeometry::getFaceCentre(p, f);
+		int i = 0;
+		for(int v = 0; v < V; v++){
+			out.faceOffsets[v] = i;
+			int h = links.vertexEdges[v];
+			do{
+				out.indices[i++] = links.faceOf[h];
+				h = links.rotate(h);
+			} while(h != links.vertexEdges[v]);
+		}
+		out.faceOffsets[V] = i;
+		return out;
+	}
+};
+
+template <>
+struct FixedOperator<'a'>{ // edge midpoints, joined around each old face and each old vertex
+	template <int V, int F, int I>
+	static constexpr FixedPolyhedron<I / 2, F + V, 2 * I> apply(FixedPolyhedron<V, F, I> const &p){
+		FixedLinks<V, F, I> const links(p);
+		FixedPolyhedron<I / 2, F + V, 2 * I> out{};
+		for(int h = 0; h < I; h++) out.vertices[links.edgeOf[h]] = FixedGeometry::lerp(p.vertices[p.indices[h]], p.vertices[p.indices[links.nexts[h]]], .5f);
+		int i = 0;
+		for(int f = 0; f < F; f++){
+			out.faceOffsets[f] = i;
+			for(int h = p.faceOffsets[f]; h < p.faceOffsets[f + 1]; h++) out.indices[i++] = links.edgeOf[h];
+		}
+		for(int v = 0; v < V; v++){
+			out.faceOffsets[F + v] = i;
+			int h = links.vertexEdges[v];
+			do{
+				out.indices[i++] = links.edgeOf[h];
+				h = links.rotate(h);
+			} while(h != links.vertexEdges[v]);
+		}
+		out.faceOffsets[F + V] = i;
+		return out;
+	}
+};
+
+template <>
+struct FixedOperator<'k'>{ // old vertices & face centres, one triangle per old half-edge
+	template <int V, int F, int I>
+	static constexpr FixedPolyhedron<V + F, I, 3 * I> apply(FixedPolyhedron<V, F, I> const &p){
+		FixedLinks<V, F, I> const links(p);
+		FixedPolyhedron<V + F, I, 3 * I> out{};
+		for(int v = 0; v < V; v++) out.vertices[v] = p.vertices[v];
+		for(int f = 0; f < F; f++) out.vertices[V + f] = FixedGeometry::getFaceCentre(p, f);
+		for(int h = 0; h < I; h++){
+			out.faceOffsets[h] = 3 * h;
+			out.indices[3 * h] = p.indices[h];
+			out.indices[3 * h + 1] = p.indices[links.nexts[h]];
+			out.indices[3 * h + 2] = V + links.faceOf[h];
+		}
+		out.faceOffsets[I] = 3 * I;
+		return out;
+	}
+};
+
+template <>
+struct FixedOperator<'g'>{ // old vertices, a third along each half-edge & face centres, one pentagon per old half-edge
+	template <int V, int F, int I>
+	static constexpr FixedPolyhedron<V + I + F, I, 5 * I> apply(FixedPolyhedron<V, F, I> const &p){
+		FixedLinks<V, F, I> const links(p);
+		FixedPolyhedron<V + I + F, I, 5 * I> out{};
+		for(int v = 0; v < V; v++) out.vertices[v] = p.vertices[v];
+		for(int h = 0; h < I; h++) out.vertices[V + h] = FixedGeometry::lerp(p.vertices[p.indices[h]], p.vertices[p.indices[links.nexts[h]]], 1.f / 3.f);
+		for(int f = 0; f < F; f++) out.vertices[V + I + f] = FixedGeometry::getFaceCentre(p, f);
+		for(int h = 0; h < I; h++){
+			out.faceOffsets[h] = 5 * h;
+			int const corners[5] = {V + I + links.faceOf[h], V + h, V + links.twins[h], p.indices[links.nexts[h]], V + links.nexts[h]};
+			for(int c = 0; c < 5; c++) out.indices[5 * h + c] = corners[c];
+		}
+		out.faceOffsets[I] = 5 * I;
+		return out;
+	}
+};
+
+// operators applied right-to-left, like a stream
+template <char... Ops>
+struct FixedChain;
+
+template <>
+struct FixedChain<>{
+	template <int V, int F, int I>
+	static constexpr FixedPolyhedron<V, F, I> apply(FixedPolyhedron<V, F, I> const &p){
+		return p;
+	}
+};
+
+template <char Op, char... Rest>
+struct FixedChain<Op, Rest...>{
+	template <int V, int F, int I>
+	static constexpr auto apply(FixedPolyhedron<V, F, I> const &p){
+		return FixedOperator<Op>::apply(FixedChain<Rest...>::apply(p));
+	}
+};
+
+// compounds, as Notation expands them: chains of d a k g, so they match the run-time chain rather than Topology's one-pass
+// t e s m b, which reach the same shape with differently numbered vertices
+template <> struct FixedOperator<'j'> : FixedChain<'d', 'a'> {};
+template <> struct FixedOperator<'n'> : FixedChain<'k', 'd'> {};
+template <> struct FixedOperator<'z'> : FixedChain<'d', 'k'> {};
+template <> struct FixedOperator<'t'> : FixedChain<'d', 'k', 'd'> {};
+template <> struct FixedOperator<'o'> : FixedChain<'d', 'a', 'a'> {};
+template <> struct FixedOperator<'e'> : FixedChain<'a', 'a'> {};
+template <> struct FixedOperator<'s'> : FixedChain<'d', 'g', 'd'> {};
+template <> struct FixedOperator<'m'> : FixedChain<'k', 'd', 'a'> {};
+template <> struct FixedOperator<'b'> : FixedChain<'d', 'k', 'd', 'a'> {};
+
+// an operator stream known at compile time, e.g. FixedStream<FixedSeed<'C'>, 't', 'k'> for tkC or
+// FixedStream<FixedPrism<5>, 'd'> for dP5; the shape & its edges are constants, costing nothing at run time
+template <typename Seed, char... Ops>
+struct FixedStream{
+	static constexpr auto value = FixedChain<Ops...>::apply(Seed::value);
+	static constexpr int vertexTotal = value.vertexTotal, faceTotal = value.faceTotal, edgeTotal = value.edgeTotal;
+	static constexpr std::array<std::array<int, 2>, edgeTotal> edges = FixedGeometry::getEdges(value);
+	static void toPolyhedron(Polyhedron &p){ // copies the constants for the run-time libraries
+		p.vertices.assign(value.vertices.begin(), value.vertices.end());
+		p.edges.assign(edges.begin(), edges.end());
+		p.faces.resize(faceTotal);
+		for(int f = 0; f < faceTotal; f++) p.faces[f].assign(value.indices.begin() + value.faceOffsets[f], value.indices.begin() + value.faceOffsets[f + 1]);
+	}
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef HEADER_NOTATION
+#define HEADER_NOTATION
+
+#include <string> // operator sequences
+
+struct Notation{
+	static bool isPrimitive(char op){ // operators applied directly by PolyhedronFactory::mutate
+		return op == 'd' || op == 'a' || op == 'k' || op == 'g' || op == 'c';
+	}
+	static std::string expand(char op){ // compound operator as primitives, applied right-to-left like a stream
+		switch(op){
+			case 'j': return "da"; // join
+			case 'n': return "kd"; // needle
+			case 'z': return "dk"; // zip
+			case 't': return "dkd"; // truncate
+			case 'o': return "daa"; // ortho
+			case 'e': return "aa"; // expand
+			case 's': return "dgd"; // snub
+			case 'm': return "kda"; // meta
+			case 'b': return "dkda"; // bevel
+			default: return isPrimitive(op) ? std::string(1, op) : std::string();
+		}
+	}
+};
+
+#endif
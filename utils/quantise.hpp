@@ -0,0 +1,47 @@
+#ifndef HEADER_QUANTISE
+#define HEADER_QUANTISE
+
+#include <vector> // vertex ranges
+#include <array> // positions & normals
+#include <cstdint> // packed fields
+#include <cmath> // rounding & scales
+#include <algorithm> // clamping
+
+#define QUANTISE_SHORT_VERTICES 65536 // vertex totals addressable by 16-bit indices
+
+struct Quantise{
+	static float getScale(std::vector<std::array<float, 3>> const &vertices){ // power of two bounding every coordinate, so scaling back is exact
+		float extent = 0;
+		for(std::array<float, 3> const &v : vertices) for(float x : v) extent = std::max(extent, std::fabs(x));
+		return extent > 0 ? std::exp2(std::ceil(std::log2(extent))) : 1.f;
+	}
+	static std::int16_t toSnorm(float x){ // [-1, 1] as GL reads normalised shorts
+		return (std::int16_t)std::lround(std::max(-1.f, std::min(1.f, x)) * 32767.f);
+	}
+	static float fromSnorm(std::int16_t x){
+		return std::max(x / 32767.f, -1.f);
+	}
+	static std::array<std::int16_t, 2> toOctahedral(std::array<float, 3> const &n){ // unit normal folded onto the octahedron, then its square
+		float const l1 = std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]);
+		if(l1 == 0) return {0, 0};
+		float x = n[0] / l1, y = n[1] / l1;
+		if(n[2] < 0){
+			float const fx = (1.f - std::fabs(y)) * (x >= 0 ? 1.f : -1.f);
+			y = (1.f - std::fabs(x)) * (y >= 0 ? 1.f : -1.f);
+			x = fx;
+		}
+		return {toSnorm(x), toSnorm(y)};
+	}
+	static std::array<float, 3> fromOctahedral(std::array<std::int16_t, 2> const &e){ // as shaders/solidwirePackedVertex.glsl decodes
+		std::array<float, 3> n = {fromSnorm(e[0]), fromSnorm(e[1]), 0};
+		n[2] = 1.f - std::fabs(n[0]) - std::fabs(n[1]);
+		float const t = std::max(-n[2], 0.f);
+		n[0] += n[0] >= 0 ? -t : t;
+		n[1] += n[1] >= 0 ? -t : t;
+		float const length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		for(float &x : n) x /= length;
+		return n;
+	}
+};
+
+#endif
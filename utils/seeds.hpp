@@ -0,0 +1,160 @@
+#ifndef HEADER_SEEDS
+#define HEADER_SEEDS
+
+#include <array> // fixed storage
+
+#define FIXED_PI 3.14159265358979323846
+#define FIXED_PHI 1.61803398874989484820f // golden ratio
+#define FIXED_SERIES_TERMS 12 // Taylor terms for sine over [-pi, pi]
+#define FIXED_ROOT_STEPS 32 // Newton steps for square roots of seed sizes
+
+// a polyhedron whose totals are part of its type, so it can be built & stored at compile time: V vertices and F faces as
+// CSR ranges over I face corners, which is twice the edge total on closed polyhedra
+template <int V, int F, int I>
+struct FixedPolyhedron{
+	static constexpr int vertexTotal = V, faceTotal = F, indexTotal = I, edgeTotal = I / 2;
+	std::array<std::array<float, 3>, V> vertices{};
+	std::array<int, F + 1> faceOffsets{}; // face f owns corners [faceOffsets[f], faceOffsets[f + 1])
+	std::array<int, I> indices{};
+};
+
+// constant-evaluated maths, as std::sin & std::sqrt are not constexpr
+struct FixedMaths{
+	static constexpr double sine(double x){
+		while(x > FIXED_PI) x -= 2 * FIXED_PI;
+		while(x < -FIXED_PI) x += 2 * FIXED_PI;
+		double term = x, sum = x;
+		for(int n = 1; n < FIXED_SERIES_TERMS; n++){
+			term *= -x * x / ((2 * n) * (2 * n + 1));
+			sum += term;
+		}
+		return sum;
+	}
+	static constexpr double cosine(double x){
+		return sine(x + FIXED_PI / 2);
+	}
+	static constexpr double root(double x){
+		double r = x > 1 ? x : 1;
+		for(int s = 0; s < FIXED_ROOT_STEPS; s++) r = (r + x / r) / 2;
+		return r;
+	}
+};
+
+// seed builders, every face anticlockwise seen from outside
+struct FixedSeeds{
+	template <int V, int F, int S> // F faces of S corners each
+	static constexpr FixedPolyhedron<V, F, F * S> regular(std::array<std::array<float, 3>, V> const &vertices, std::array<int, F * S> const &indices){
+		FixedPolyhedron<V, F, F * S> p{};
+		p.vertices = vertices;
+		p.indices = indices;
+		for(int f = 0; f <= F; f++) p.faceOffsets[f] = f * S;
+		return p;
+	}
+	template <int N> // unit circumradius, square sides
+	static constexpr FixedPolyhedron<2 * N, N + 2, 6 * N> prism(){
+		FixedPolyhedron<2 * N, N + 2, 6 * N> p{};
+		double const height = FixedMaths::sine(FIXED_PI / N); // half the side
+		for(int k = 0; k < N; k++){
+			double const angle = 2 * FIXED_PI * k / N;
+			p.vertices[k] = {(float)FixedMaths::cosine(angle), (float)FixedMaths::sine(angle), (float)height};
+			p.vertices[N + k] = {(float)FixedMaths::cosine(angle), (float)FixedMaths::sine(angle), (float)-height};
+		}
+		int i = 0, f = 0;
+		p.faceOffsets[f++] = i;
+		for(int k = 0; k < N; k++) p.indices[i++] = k;
+		p.faceOffsets[f++] = i;
+		for(int k = 0; k < N; k++) p.indices[i++] = 2 * N - 1 - k;
+		for(int k = 0; k < N; k++){
+			p.faceOffsets[f++] = i;
+			for(int c : {k, N + k, N + (k + 1) % N, (k + 1) % N}) p.indices[i++] = c;
+		}
+		p.faceOffsets[f] = i;
+		return p;
+	}
+	template <int N> // unit circumradius, equilateral sides
+	static constexpr FixedPolyhedron<2 * N, 2 * N + 2, 8 * N> antiprism(){
+		FixedPolyhedron<2 * N, 2 * N + 2, 8 * N> p{};
+		double const side = 2 * FixedMaths::sine(FIXED_PI / N), offset = 2 * FixedMaths::sine(FIXED_PI / (2 * N));
+		double const height = FixedMaths::root(side * side - offset * offset) / 2;
+		for(int k = 0; k < N; k++){
+			double const angle = 2 * FIXED_PI * k / N, twist = angle + FIXED_PI / N;
+			p.vertices[k] = {(float)FixedMaths::cosine(angle), (float)FixedMaths::sine(angle), (float)height};
+			p.vertices[N + k] = {(float)FixedMaths::cosine(twist), (float)FixedMaths::sine(twist), (float)-height};
+		}
+		int i = 0, f = 0;
+		p.faceOffsets[f++] = i;
+		for(int k = 0; k < N; k++) p.indices[i++] = k;
+		p.faceOffsets[f++] = i;
+		for(int k = 0; k < N; k++) p.indices[i++] = 2 * N - 1 - k;
+		for(int k = 0; k < N; k++){
+			p.faceOffsets[f++] = i;
+			for(int c : {k, N + k, (k + 1) % N}) p.indices[i++] = c;
+			p.faceOffsets[f++] = i;
+			for(int c : {N + k, N + (k + 1) % N, (k + 1) % N}) p.indices[i++] = c;
+		}
+		p.faceOffsets[f] = i;
+		return p;
+	}
+};
+
+// seeds by notation letter, each a constant baked into the binary
+template <char Seed>
+struct FixedSeed{
+	static_assert(Seed == 0, "seed has no compile-time table");
+};
+
+template <>
+struct FixedSeed<'T'>{
+	static constexpr FixedPolyhedron<4, 4, 12> value = FixedSeeds::regular<4, 4, 3>(
+		{{{1, 1, 1}, {1, -1, -1}, {-1, 1, -1}, {-1, -1, 1}}},
+		{0, 1, 2, 0, 3, 1, 0, 2, 3, 1, 3, 2});
+};
+
+template <>
+struct FixedSeed<'C'>{
+	static constexpr FixedPolyhedron<8, 6, 24> value = FixedSeeds::regular<8, 6, 4>(
+		{{{-1, -1, -1}, {1, -1, -1}, {1, 1, -1}, {-1, 1, -1}, {-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}}},
+		{0, 3, 2, 1, 0, 1, 5, 4, 0, 4, 7, 3, 1, 2, 6, 5, 2, 3, 7, 6, 4, 5, 6, 7});
+};
+
+template <>
+struct FixedSeed<'O'>{
+	static constexpr FixedPolyhedron<6, 8, 24> value = FixedSeeds::regular<6, 8, 3>(
+		{{{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}}},
+		{0, 2, 4, 0, 5, 2, 0, 4, 3, 0, 3, 5, 1, 4, 2, 1, 2, 5, 1, 3, 4, 1, 5, 3});
+};
+
+template <>
+struct FixedSeed<'D'>{
+	static constexpr FixedPolyhedron<20, 12, 60> value = FixedSeeds::regular<20, 12, 5>(
+		{{{1, 1, 1}, {1, 1, -1}, {1, -1, 1}, {1, -1, -1}, {-1, 1, 1}, {-1, 1, -1}, {-1, -1, 1}, {-1, -1, -1},
+		{0, 1 / FIXED_PHI, FIXED_PHI}, {1 / FIXED_PHI, FIXED_PHI, 0}, {FIXED_PHI, 0, 1 / FIXED_PHI},
+		{0, 1 / FIXED_PHI, -FIXED_PHI}, {1 / FIXED_PHI, -FIXED_PHI, 0}, {-FIXED_PHI, 0, 1 / FIXED_PHI},
+		{0, -1 / FIXED_PHI, FIXED_PHI}, {-1 / FIXED_PHI, FIXED_PHI, 0}, {FIXED_PHI, 0, -1 / FIXED_PHI},
+		{0, -1 / FIXED_PHI, -FIXED_PHI}, {-1 / FIXED_PHI, -FIXED_PHI, 0}, {-FIXED_PHI, 0, -1 / FIXED_PHI}}},
+		{0, 10, 16, 1, 9, 0, 8, 14, 2, 10, 0, 9, 15, 4, 8, 1, 16, 3, 17, 11, 1, 11, 5, 15, 9, 2, 12, 3, 16, 10,
+		2, 14, 6, 18, 12, 3, 12, 18, 7, 17, 4, 15, 5, 19, 13, 4, 13, 6, 14, 8, 5, 11, 17, 7, 19, 6, 13, 19, 7, 18});
+};
+
+template <>
+struct FixedSeed<'I'>{
+	static constexpr FixedPolyhedron<12, 20, 60> value = FixedSeeds::regular<12, 20, 3>(
+		{{{0, 1, FIXED_PHI}, {1, FIXED_PHI, 0}, {FIXED_PHI, 0, 1}, {0, 1, -FIXED_PHI}, {1, -FIXED_PHI, 0}, {-FIXED_PHI, 0, 1},
+		{0, -1, FIXED_PHI}, {-1, FIXED_PHI, 0}, {FIXED_PHI, 0, -1}, {0, -1, -FIXED_PHI}, {-1, -FIXED_PHI, 0}, {-FIXED_PHI, 0, -1}}},
+		{0, 2, 1, 0, 1, 7, 0, 6, 2, 0, 5, 6, 0, 7, 5, 1, 2, 8, 1, 3, 7, 1, 8, 3, 2, 6, 4, 2, 4, 8,
+		3, 11, 7, 3, 8, 9, 3, 9, 11, 4, 6, 10, 4, 9, 8, 4, 10, 9, 5, 10, 6, 5, 7, 11, 5, 11, 10, 9, 10, 11});
+};
+
+template <int N>
+struct FixedPrism{ // P3, P4, ...
+	static_assert(N >= 3, "prisms need at least three sides");
+	static constexpr FixedPolyhedron<2 * N, N + 2, 6 * N> value = FixedSeeds::prism<N>();
+};
+
+template <int N>
+struct FixedAntiprism{ // A3, A4, ...
+	static_assert(N >= 3, "antiprisms need at least three sides");
+	static constexpr FixedPolyhedron<2 * N, 2 * N + 2, 8 * N> value = FixedSeeds::antiprism<N>();
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef HEADER_USAGE
+#define HEADER_USAGE
+
+#include <chrono> // wall-clock timing
+#include <cstddef> // memory sizes
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h> // process handle
+#include <psapi.h> // process memory counters
+#else
+#include <sys/resource.h> // process resource usage
+#endif
+
+struct Usage{
+	static std::size_t getPeakMemory(){ // bytes of peak resident memory for this process
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+		return counters.PeakWorkingSetSize;
+#else
+		struct rusage usage;
+		if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+		return usage.ru_maxrss;
+#else
+		return (std::size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+	}
+};
+
+class Stopwatch{
+	std::chrono::steady_clock::time_point start;
+public:
+	Stopwatch() : start(std::chrono::steady_clock::now()) {}
+	void reset(){ start = std::chrono::steady_clock::now(); }
+	double getSeconds() const {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+};
+
+#endif